@@ -22,7 +22,7 @@ INCLUDEPATH += $$PWD/include
 LIBS += -L$$PWD/lib
 
 unix:{
-    LIBS += -lglfw -lGL -lGLEW
+    LIBS += -lglfw -lGL -lGLEW -lEGL -lpthread
 }
 win32:{
     LIBS += -lglfw3dll -lopengl32 -lglew32dll
@@ -35,41 +35,79 @@ SOURCES += \
     src/input/input.cpp \
     src/input/inputglfw.cpp \
     src/main.cpp \
+    src/render/backendgl.cpp \
+    src/render/backendnull.cpp \
+    src/render/bufferarena.cpp \
+    src/render/commandbuffer.cpp \
+    src/render/framebuilder.cpp \
+    src/render/offscreencontext.cpp \
+    src/render/renderbackend.cpp \
     src/render/renderer.cpp \
+    src/render/renderqueue.cpp \
     src/res/imagedata.cpp \
+    src/scene/assetcache.cpp \
     src/scene/camera.cpp \
     src/scene/frustum.cpp \
     src/scene/light.cpp \
+    src/scene/meshopt.cpp \
     src/scene/model.cpp \
     src/scene/material.cpp \
     src/scene/scenecmp.cpp \
     src/scene/sceneentitybuilder.cpp \
+    src/scene/snapshot.cpp \
+    src/scene/streaming.cpp \
+    src/utils/allocstats.cpp \
+    src/utils/binarystream.cpp \
     src/utils/controller.cpp \
+    src/utils/framearena.cpp \
+    src/utils/mappedfile.cpp \
+    src/utils/threadpool.cpp \
     src/window.cpp
 
 HEADERS += \
     src/ent/entt_traits.hpp \
     src/ent/family.hpp \
+    src/ent/observer.hpp \
     src/ent/registry.hpp \
+    src/ent/sigh.hpp \
+    src/ent/snapshot.hpp \
     src/ent/sparse_set.hpp \
     src/ent/view.hpp \
     src/input/arcball.h \
     src/input/input.h \
     src/input/inputglfw.h \
     src/input/key_codes.h \
+    src/render/backendgl.h \
+    src/render/backendnull.h \
+    src/render/bufferarena.h \
+    src/render/commandbuffer.h \
+    src/render/framebuilder.h \
+    src/render/offscreencontext.h \
     src/render/render_states.h \
+    src/render/renderbackend.h \
     src/render/renderer.h \
+    src/render/renderqueue.h \
     src/res/imagedata.h \
     src/scene/AABB.h \
+    src/scene/assetcache.h \
+    src/scene/affine.h \
     src/scene/camera.h \
     src/scene/frustum.h \
     src/scene/light.h \
     src/scene/material.h \
+    src/scene/meshopt.h \
     src/scene/model.h \
     src/scene/plane.h \
     src/scene/scenecmp.h \
     src/scene/sceneentitybuilder.h \
+    src/scene/snapshot.h \
+    src/scene/streaming.h \
+    src/utils/allocstats.h \
+    src/utils/binarystream.h \
     src/utils/controller.h \
+    src/utils/framearena.h \
+    src/utils/mappedfile.h \
+    src/utils/threadpool.h \
     src/window.h
 
 DISTFILES +=
@@ -0,0 +1,121 @@
+#ifndef ENTT_ENTITY_OBSERVER_HPP
+#define ENTT_ENTITY_OBSERVER_HPP
+
+#include <cstddef>
+#include "registry.hpp"
+#include "sparse_set.hpp"
+
+namespace entt
+{
+
+// Collects the entities whose Component is assigned or replaced while they
+// have all of Require, until clear(). An entity leaves the collection when it
+// loses Component or one of Require, so a destroyed entity is never seen.
+template<typename Entity>
+class Observer final
+{
+    using registry_type = Registry<Entity>;
+    using release_type  = void (*)(registry_type &, Observer *);
+
+    template<typename... Require>
+    void collect(registry_type & reg, Entity entity)
+    {
+        if constexpr(sizeof...(Require) > 0)
+        {
+            if(!reg.template has<Require...>(entity))
+            {
+                return;
+            }
+        }
+
+        if(!storage.has(entity))
+        {
+            storage.construct(entity);
+        }
+    }
+
+    void discard(registry_type &, Entity entity)
+    {
+        if(storage.has(entity))
+        {
+            storage.destroy(entity);
+        }
+    }
+
+    template<typename Component, typename... Require>
+    static void release(registry_type & reg, Observer * observer)
+    {
+        reg.template on_construct<Component>().disconnect(observer);
+        reg.template on_replace<Component>().disconnect(observer);
+        reg.template on_destroy<Component>().disconnect(observer);
+        (reg.template on_destroy<Require>().disconnect(observer), ...);
+    }
+
+public:
+    using entity_type   = Entity;
+    using size_type     = std::size_t;
+    using iterator_type = typename SparseSet<Entity>::iterator_type;
+
+    Observer() = default;
+    ~Observer() { disconnect(); }
+
+    Observer(Observer const &)             = delete;
+    Observer & operator=(Observer const &) = delete;
+
+    template<typename Component, typename... Require>
+    void connect(registry_type & reg)
+    {
+        disconnect();
+
+        constexpr auto collector = &Observer::template collect<Require...>;
+
+        reg.template on_construct<Component>().template connect<Observer, collector>(this);
+        reg.template on_replace<Component>().template connect<Observer, collector>(this);
+        reg.template on_destroy<Component>().template connect<Observer, &Observer::discard>(this);
+        (reg.template on_destroy<Require>().template connect<Observer, &Observer::discard>(this), ...);
+
+        registry = &reg;
+        releaser = &Observer::release<Component, Require...>;
+    }
+
+    void disconnect()
+    {
+        if(registry)
+        {
+            releaser(*registry, this);
+            registry = nullptr;
+        }
+
+        clear();
+    }
+
+    size_type size() const noexcept { return storage.size(); }
+
+    bool empty() const noexcept { return storage.empty(); }
+
+    bool contains(entity_type entity) const noexcept { return storage.has(entity); }
+
+    entity_type const * data() const noexcept { return storage.data(); }
+
+    iterator_type begin() const noexcept { return storage.begin(); }
+
+    iterator_type end() const noexcept { return storage.end(); }
+
+    // from the back, the sparse part is kept
+    void clear() noexcept
+    {
+        while(!storage.empty())
+        {
+            storage.destroy(*storage.begin());
+        }
+    }
+
+private:
+    SparseSet<Entity> storage;
+    registry_type *   registry = nullptr;
+    release_type      releaser = nullptr;
+};
+
+}   // namespace entt
+
+#endif   // ENTT_ENTITY_OBSERVER_HPP
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cassert>
 #include "family.hpp"
+#include "sigh.hpp"
 #include "sparse_set.hpp"
 #include "view.hpp"
 
@@ -25,6 +26,18 @@ class Registry
     template<typename Component>
     using pool_instance = SparseSet<Entity, Component>;
 
+    using signal_type = SigH<Registry &, Entity>;
+
+    struct Handlers
+    {
+        signal_type construction;
+        signal_type replacement;
+        signal_type destruction;
+    };
+
+    template<typename, typename...>
+    friend class Snapshot;
+
     template<typename Component>
     bool managed() const noexcept
     {
@@ -64,10 +77,41 @@ class Registry
         return pool<Component>();
     }
 
+    template<typename Component>
+    Handlers & handlers()
+    {
+        auto const ctype = component_family::type<Component>();
+
+        if(!(ctype < signals.size()))
+        {
+            signals.resize(ctype + 1);
+        }
+
+        if(!signals[ctype])
+        {
+            signals[ctype] = std::make_unique<Handlers>();
+        }
+
+        return *signals[ctype];
+    }
+
+    // null if nobody has ever listened to the pool
+    Handlers const * listeners(std::size_t ctype) const noexcept
+    {
+        return ctype < signals.size() ? signals[ctype].get() : nullptr;
+    }
+
+    template<typename Component>
+    Handlers const * listeners() const noexcept
+    {
+        return listeners(component_family::type<Component>());
+    }
+
 public:
     using entity_type  = typename traits_type::entity_type;
     using version_type = typename traits_type::version_type;
     using size_type    = std::size_t;
+    using sink_type    = Sink<Registry &, entity_type>;
 
     explicit Registry() = default;
     ~Registry()         = default;
@@ -88,6 +132,25 @@ public:
 
     size_type capacity() const noexcept { return entities.size(); }
 
+    // bytes held by the pools and the entity lists, the heap data owned by
+    // components is not included
+    size_type memory() const noexcept
+    {
+        size_type bytes = (entities.capacity() + available.capacity()) * sizeof(entity_type)
+                          + pools.capacity() * sizeof(typename decltype(pools)::value_type)
+                          + signals.capacity() * sizeof(typename decltype(signals)::value_type);
+
+        for(auto && cpool : pools)
+        {
+            if(cpool)
+            {
+                bytes += cpool->memory();
+            }
+        }
+
+        return bytes;
+    }
+
     template<typename Component>
     bool empty() const noexcept
     {
@@ -119,7 +182,7 @@ public:
     {
         using accumulator_type       = int[];
         auto const       entity      = create();
-        accumulator_type accumulator = {0, (ensure<Component>().construct(entity), 0)...};
+        accumulator_type accumulator = {0, (assign<Component>(entity), 0)...};
         (void)accumulator;
         return entity;
     }
@@ -147,32 +210,65 @@ public:
     {
         assert(valid(entity));
 
+        // the entity is still valid for the listeners, they may add pools
+        for(size_type pos = 0; pos < pools.size(); ++pos)
+        {
+            if(pools[pos] && pools[pos]->has(entity))
+            {
+                if(auto const * handlers = listeners(pos))
+                {
+                    handlers->destruction.publish(*this, entity);
+                }
+
+                pools[pos]->destroy(entity);
+            }
+        }
+
         auto const entt    = entity & traits_type::entity_mask;
         auto const version = 1 + ((entity >> traits_type::version_shift) & traits_type::version_mask);
         entities[entt]     = entt | (version << traits_type::version_shift);
         available.push_back(entities[entt]);
+    }
 
-        for(auto && cpool : pools)
+    template<typename Component, typename... Args>
+    Component & assign(entity_type entity, Args &&... args)
+    {
+        assert(valid(entity));
+        ensure<Component>().construct(entity, std::forward<Args>(args)...);
+
+        if(auto const * handlers = listeners<Component>())
         {
-            if(cpool && cpool->has(entity))
-            {
-                cpool->destroy(entity);
-            }
+            handlers->construction.publish(*this, entity);
         }
+
+        // the listeners may have grown the pool
+        return pool<Component>().get(entity);
     }
 
-    template<typename Component, typename... Args>
-    Component & assign(entity_type entity, Args &&... args)
+    // publishes a replacement of a component changed in place through get()
+    template<typename Component>
+    void notify_replace(entity_type entity)
     {
         assert(valid(entity));
-        return ensure<Component>().construct(entity, std::forward<Args>(args)...);
+
+        if(auto const * handlers = listeners<Component>())
+        {
+            handlers->replacement.publish(*this, entity);
+        }
     }
 
     template<typename Component, typename... Args>
     Component & replace(entity_type entity, Args &&... args)
     {
         assert(valid(entity));
-        return (pool<Component>().get(entity) = Component{std::forward<Args>(args)...});
+        pool<Component>().get(entity) = Component{std::forward<Args>(args)...};
+
+        if(auto const * handlers = listeners<Component>())
+        {
+            handlers->replacement.publish(*this, entity);
+        }
+
+        return pool<Component>().get(entity);
     }
 
     template<typename Component, typename... Args>
@@ -188,7 +284,13 @@ public:
     void remove(entity_type entity)
     {
         assert(valid(entity));
-        return pool<Component>().destroy(entity);
+
+        if(auto const * handlers = listeners<Component>())
+        {
+            handlers->destruction.publish(*this, entity);
+        }
+
+        pool<Component>().destroy(entity);
     }
 
     template<typename... Component>
@@ -240,14 +342,9 @@ public:
     {
         assert(valid(entity));
 
-        if(managed<Component>())
+        if(managed<Component>() && pool<Component>().has(entity))
         {
-            auto & cpool = pool<Component>();
-
-            if(cpool.has(entity))
-            {
-                cpool.destroy(entity);
-            }
+            remove<Component>(entity);
         }
     }
 
@@ -258,6 +355,14 @@ public:
         {
             auto & cpool = pool<Component>();
 
+            if(auto const * handlers = listeners<Component>())
+            {
+                for(auto entity : cpool)
+                {
+                    handlers->destruction.publish(*this, entity);
+                }
+            }
+
             cpool.reset();   /// !!!!!!!!!!!!!!!!!!!
             /*for(auto entity : entities)
             {
@@ -271,6 +376,19 @@ public:
 
     void reset()
     {
+        for(size_type pos = 0; pos < pools.size(); ++pos)
+        {
+            auto const * handlers = listeners(pos);
+
+            if(pools[pos] && handlers)
+            {
+                for(auto entity : *pools[pos])
+                {
+                    handlers->destruction.publish(*this, entity);
+                }
+            }
+        }
+
         available.clear();
         pools.clear();
 
@@ -282,6 +400,26 @@ public:
         }
     }
 
+    // the listeners are called after a component is assigned or replaced and
+    // before it's removed, a replace through get() is seen after notify_replace
+    template<typename Component>
+    sink_type on_construct()
+    {
+        return sink_type{handlers<Component>().construction};
+    }
+
+    template<typename Component>
+    sink_type on_replace()
+    {
+        return sink_type{handlers<Component>().replacement};
+    }
+
+    template<typename Component>
+    sink_type on_destroy()
+    {
+        return sink_type{handlers<Component>().destruction};
+    }
+
     template<typename... Component>
     View<Entity, Component...> view()
     {
@@ -321,6 +459,7 @@ public:
 
 private:
     std::vector<std::unique_ptr<SparseSet<Entity>>> pools;
+    std::vector<std::unique_ptr<Handlers>>          signals;
     std::vector<entity_type>                        available;
     std::vector<entity_type>                        entities;
     std::map<std::size_t, std::any>                 context;
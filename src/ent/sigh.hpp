@@ -0,0 +1,120 @@
+#ifndef ENTT_SIGNAL_SIGH_HPP
+#define ENTT_SIGNAL_SIGH_HPP
+
+#include <algorithm>
+#include <vector>
+
+namespace entt
+{
+
+template<typename... Args>
+class Sink;
+
+// List of listeners, a listener is a free function or a member function bound
+// to an instance. Listeners must not connect or disconnect themselves from the
+// signal they're called by.
+template<typename... Args>
+class SigH
+{
+    friend class Sink<Args...>;
+
+    using function_type = void (*)(void *, Args...);
+
+    struct Call
+    {
+        function_type function;
+        void *        instance;
+    };
+
+    template<void (*Function)(Args...)>
+    static void proto(void *, Args... args)
+    {
+        (Function)(args...);
+    }
+
+    template<typename Class, void (Class::*Member)(Args...)>
+    static void proto(void * instance, Args... args)
+    {
+        (static_cast<Class *>(instance)->*Member)(args...);
+    }
+
+public:
+    using size_type = std::size_t;
+
+    size_type size() const noexcept { return calls.size(); }
+
+    bool empty() const noexcept { return calls.empty(); }
+
+    void publish(Args... args) const
+    {
+        for(auto const & call : calls)
+        {
+            call.function(call.instance, args...);
+        }
+    }
+
+private:
+    std::vector<Call> calls;
+};
+
+template<typename... Args>
+class Sink
+{
+    using signal_type = SigH<Args...>;
+    using call_type   = typename signal_type::Call;
+
+public:
+    explicit Sink(signal_type & signal) noexcept : signal{signal} {}
+
+    template<void (*Function)(Args...)>
+    void connect()
+    {
+        disconnect<Function>();
+        signal.calls.push_back(call_type{&signal_type::template proto<Function>, nullptr});
+    }
+
+    template<typename Class, void (Class::*Member)(Args...)>
+    void connect(Class * instance)
+    {
+        disconnect<Class, Member>(instance);
+        signal.calls.push_back(call_type{&signal_type::template proto<Class, Member>, instance});
+    }
+
+    template<void (*Function)(Args...)>
+    void disconnect()
+    {
+        remove(&signal_type::template proto<Function>, nullptr);
+    }
+
+    template<typename Class, void (Class::*Member)(Args...)>
+    void disconnect(Class * instance)
+    {
+        remove(&signal_type::template proto<Class, Member>, instance);
+    }
+
+    // every member function bound to the instance
+    void disconnect(void const * instance)
+    {
+        auto & calls = signal.calls;
+        calls.erase(std::remove_if(calls.begin(), calls.end(),
+                                   [instance](auto const & call) { return call.instance == instance; }),
+                    calls.end());
+    }
+
+private:
+    void remove(typename signal_type::function_type function, void const * instance)
+    {
+        auto & calls = signal.calls;
+        calls.erase(std::remove_if(calls.begin(), calls.end(),
+                                   [function, instance](auto const & call) {
+                                       return call.function == function && call.instance == instance;
+                                   }),
+                    calls.end());
+    }
+
+    signal_type & signal;
+};
+
+}   // namespace entt
+
+#endif   // ENTT_SIGNAL_SIGH_HPP
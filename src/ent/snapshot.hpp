@@ -0,0 +1,357 @@
+#ifndef ENTT_ENTITY_SNAPSHOT_HPP
+#define ENTT_ENTITY_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "registry.hpp"
+#include "sparse_set.hpp"
+
+namespace entt
+{
+
+// components are compared and dumped as raw bytes, padding would make both
+// depend on indeterminate values. Floats have no unique representation
+// (+0 and -0), components made of them are specialized by the user.
+template<typename Type>
+struct is_padding_free : std::bool_constant<std::has_unique_object_representations_v<Type>>
+{};
+
+// Copies the entity lists and the pools of the given components to an archive
+// and back, components are dumped as raw dense arrays. The state of the last
+// record is kept as the base of the next delta, a delta carries the entity
+// lists if they have changed and per pool the dense order if it has changed
+// plus the slots whose bytes differ. Loading a delta writes the changed slots
+// in place. Pools of other components keep their data, components of the
+// entities destroyed by a record are dropped. The pools are written directly,
+// only the components a record drops are published to their destruction
+// listeners first, so an observer never keeps an entity that lost them.
+//
+// Archive: void writeBytes(void const *, size_t) and bool readBytes(void *, size_t)
+template<typename Entity, typename... Component>
+class Snapshot
+{
+    static_assert((std::is_trivially_copyable<Component>::value && ...),
+                  "components are dumped as raw bytes");
+    static_assert((is_padding_free<Component>::value && ...), "components are compared as raw bytes");
+
+    using registry_type = Registry<Entity>;
+    using traits_type   = entt_traits<Entity>;
+
+    static constexpr std::uint8_t full_record  = 0;
+    static constexpr std::uint8_t delta_record = 1;
+    // every vector is indexed by entities
+    static constexpr std::uint64_t max_size = std::uint64_t{traits_type::entity_mask} + 1;
+
+    template<typename Type>
+    struct PoolState
+    {
+        std::vector<Entity>        direct;
+        std::vector<Type>          instances;
+        std::vector<std::uint32_t> changed;   // slots of the last delta
+        bool                       reordered = false;
+    };
+
+    template<typename Archive, typename Type>
+    static void write(Archive & out, Type const & value)
+    {
+        out.writeBytes(&value, sizeof(Type));
+    }
+
+    template<typename Archive, typename Type>
+    static void write(Archive & out, Type const * data, std::size_t size)
+    {
+        write(out, std::uint64_t{size});
+        out.writeBytes(data, size * sizeof(Type));
+    }
+
+    template<typename Archive, typename Type>
+    static bool read(Archive & in, Type & value)
+    {
+        return in.readBytes(&value, sizeof(Type));
+    }
+
+    template<typename Archive, typename Type>
+    static bool read(Archive & in, std::vector<Type> & vec)
+    {
+        std::uint64_t size = 0;
+        if(!read(in, size) || size > max_size)
+            return false;
+
+        vec.resize(static_cast<std::size_t>(size));
+        return in.readBytes(vec.data(), vec.size() * sizeof(Type));
+    }
+
+    template<typename Type>
+    static std::size_t poolSize(registry_type const & reg)
+    {
+        return reg.template managed<Type>() ? reg.template pool<Type>().size() : 0;
+    }
+
+    template<typename Archive, typename Type>
+    void savePool(registry_type const & reg, Archive & out)
+    {
+        auto &     state = std::get<PoolState<Type>>(pools);
+        auto const size  = poolSize<Type>(reg);
+
+        state.direct.resize(size);
+        state.instances.resize(size);
+        if(size > 0)
+        {
+            auto const & cpool = reg.template pool<Type>();
+            std::memcpy(state.direct.data(), cpool.data(), size * sizeof(Entity));
+            std::memcpy(state.instances.data(), cpool.raw(), size * sizeof(Type));
+        }
+
+        write(out, state.direct.data(), size);
+        write(out, state.instances.data(), size);
+    }
+
+    template<typename Archive, typename Type>
+    void savePoolDelta(registry_type const & reg, Archive & out)
+    {
+        auto &     state = std::get<PoolState<Type>>(pools);
+        auto const size  = poolSize<Type>(reg);
+
+        Entity const * direct = size > 0 ? reg.template pool<Type>().data() : nullptr;
+        Type const *   raw    = size > 0 ? reg.template pool<Type>().raw() : nullptr;
+
+        state.reordered =
+            size != state.direct.size()
+            || (size > 0 && std::memcmp(direct, state.direct.data(), size * sizeof(Entity)) != 0);
+
+        // a slot that holds another entity now has changed as well
+        state.changed.clear();
+        if(state.reordered
+           || (size > 0 && std::memcmp(raw, state.instances.data(), size * sizeof(Type)) != 0))
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                bool const same_entity = i < state.direct.size() && state.direct[i] == direct[i];
+                if(!same_entity || std::memcmp(&raw[i], &state.instances[i], sizeof(Type)) != 0)
+                    state.changed.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        write(out, std::uint8_t{state.reordered});
+        if(state.reordered)
+            write(out, direct, size);
+
+        write(out, static_cast<std::uint32_t>(state.changed.size()));
+        for(auto slot : state.changed)
+        {
+            write(out, slot);
+            write(out, raw[slot]);
+        }
+
+        state.direct.resize(size);
+        state.instances.resize(size);
+        if(size > 0)
+        {
+            std::memcpy(state.direct.data(), direct, size * sizeof(Entity));
+            std::memcpy(state.instances.data(), raw, size * sizeof(Type));
+        }
+    }
+
+    template<typename Archive, typename Type>
+    bool loadPool(Archive & in)
+    {
+        auto & state = std::get<PoolState<Type>>(pools);
+
+        state.reordered = true;
+        state.changed.clear();
+
+        return read(in, state.direct) && read(in, state.instances)
+               && state.direct.size() == state.instances.size();
+    }
+
+    template<typename Archive, typename Type>
+    bool loadPoolDelta(Archive & in)
+    {
+        auto & state = std::get<PoolState<Type>>(pools);
+
+        std::uint8_t reordered = 0;
+        if(!read(in, reordered))
+            return false;
+
+        state.reordered = reordered != 0;
+        if(state.reordered)
+        {
+            if(!read(in, state.direct))
+                return false;
+            state.instances.resize(state.direct.size());
+        }
+
+        std::uint32_t num_changed = 0;
+        if(!read(in, num_changed) || num_changed > state.direct.size())
+            return false;
+
+        state.changed.resize(num_changed);
+        for(auto & slot : state.changed)
+        {
+            if(!read(in, slot) || slot >= state.instances.size() || !read(in, state.instances[slot]))
+                return false;
+        }
+
+        return true;
+    }
+
+    template<typename Type>
+    void restorePool(registry_type & reg) const
+    {
+        auto const & state = std::get<PoolState<Type>>(pools);
+        auto &       cpool = reg.template ensure<Type>();
+
+        // the slots of a delta are those of the base, the pool may have
+        // changed since, e.g. on a rollback
+        bool const same_order =
+            cpool.size() == state.direct.size()
+            && (cpool.size() == 0
+                || std::memcmp(cpool.data(), state.direct.data(), cpool.size() * sizeof(Entity)) == 0);
+
+        if(state.reordered || !same_order)
+        {
+            if(auto const * handlers = reg.template listeners<Type>())
+            {
+                SparseSet<Entity> kept;
+                for(auto entity : state.direct)
+                    kept.construct(entity);
+
+                for(auto pos = cpool.size(); pos > 0; --pos)
+                {
+                    auto const entity = cpool.data()[pos - 1];
+                    if(!kept.has(entity))
+                        handlers->destruction.publish(reg, entity);
+                }
+            }
+
+            cpool.reset();
+            for(std::size_t i = 0; i < state.direct.size(); ++i)
+                cpool.construct(state.direct[i], state.instances[i]);
+        }
+        else
+        {
+            for(auto slot : state.changed)
+                cpool.raw()[slot] = state.instances[slot];
+        }
+    }
+
+    void restoreEntities(registry_type & reg) const
+    {
+        // components of the entities that are gone, they are still valid for the listeners
+        for(std::size_t ctype = 0; ctype < reg.pools.size(); ++ctype)
+        {
+            for(auto pos = reg.pools[ctype] ? reg.pools[ctype]->size() : 0; pos > 0; --pos)
+            {
+                auto &     cpool  = *reg.pools[ctype];
+                auto const entity = cpool.data()[pos - 1];
+                auto const entt   = entity & traits_type::entity_mask;
+                if(entt < entities.size() && entities[entt] == entity)
+                    continue;
+
+                if(auto const * handlers = reg.listeners(ctype))
+                    handlers->destruction.publish(reg, entity);
+
+                cpool.destroy(entity);
+            }
+        }
+
+        reg.entities  = entities;
+        reg.available = available;
+    }
+
+public:
+    // the base of the deltas is set by the first record
+    bool hasBase() const noexcept { return based; }
+    void clearBase() noexcept { based = false; }
+
+    template<typename Archive>
+    void save(registry_type const & reg, Archive & out)
+    {
+        entities  = reg.entities;
+        available = reg.available;
+
+        write(out, full_record);
+        write(out, entities.data(), entities.size());
+        write(out, available.data(), available.size());
+        (savePool<Archive, Component>(reg, out), ...);
+
+        based = true;
+    }
+
+    // a full record without a base
+    template<typename Archive>
+    void saveDelta(registry_type const & reg, Archive & out)
+    {
+        if(!based)
+        {
+            save(reg, out);
+            return;
+        }
+
+        bool const lists_changed = entities != reg.entities || available != reg.available;
+        if(lists_changed)
+        {
+            entities  = reg.entities;
+            available = reg.available;
+        }
+
+        write(out, delta_record);
+        write(out, std::uint8_t{lists_changed});
+        if(lists_changed)
+        {
+            write(out, entities.data(), entities.size());
+            write(out, available.data(), available.size());
+        }
+        (savePoolDelta<Archive, Component>(reg, out), ...);
+    }
+
+    // reads the whole record before the registry is touched, after a failed
+    // read the base is gone until the next full record
+    template<typename Archive>
+    bool load(registry_type & reg, Archive & in)
+    {
+        std::uint8_t type = 0;
+        if(!read(in, type) || (type != full_record && (type != delta_record || !based)))
+            return false;
+
+        bool          lists_changed = true;
+        std::uint8_t  lists_flag    = 1;
+        bool          done          = true;
+        if(type == delta_record)
+        {
+            done          = read(in, lists_flag);
+            lists_changed = lists_flag != 0;
+        }
+
+        if(done && lists_changed)
+            done = read(in, entities) && read(in, available);
+
+        if(type == full_record)
+            done = done && (loadPool<Archive, Component>(in) && ...);
+        else
+            done = done && (loadPoolDelta<Archive, Component>(in) && ...);
+
+        based = done;
+        if(!done)
+            return false;
+
+        if(lists_changed)
+            restoreEntities(reg);
+        (restorePool<Component>(reg), ...);
+
+        return true;
+    }
+
+private:
+    std::vector<Entity>                 entities;
+    std::vector<Entity>                 available;
+    std::tuple<PoolState<Component>...> pools;
+    bool                                based = false;
+};
+
+}   // namespace entt
+
+#endif   // ENTT_ENTITY_SNAPSHOT_HPP
@@ -69,6 +69,11 @@ public:
 
     entity_type const * data() const noexcept { return direct.data(); }
 
+    virtual size_type memory() const noexcept
+    {
+        return (reverse.capacity() + direct.capacity()) * sizeof(entity_type);
+    }
+
     iterator_type begin() const noexcept { return Iterator{&direct, direct.size()}; }
 
     iterator_type end() const noexcept { return Iterator{&direct, 0}; }
@@ -214,6 +219,11 @@ public:
 
     type const * raw() const noexcept { return instances.data(); }
 
+    size_type memory() const noexcept override
+    {
+        return base_type::memory() + instances.capacity() * sizeof(type);
+    }
+
     type * raw() noexcept { return instances.data(); }
 
     type const & get(entity_type entity) const noexcept { return instances[base_type::get(entity)]; }
@@ -1,15 +1,136 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <string>
 
 #include "window.h"
 
-int main(void)
+namespace
 {
+void PrintUsage()
+{
+    std::cout << "usage: pyr_bump [--backend=gl|null|record] [--offscreen] [--frames=N] [--dump=N]\n"
+                 "                [--log=FILE] [--world=FILE] [--snapshot=FILE] [--state=FILE]\n"
+                 "                [--verify-state]\n"
+                 "  null and record run N frames headless and print the CPU frame cost,\n"
+                 "  record writes the GL call stream to FILE (render.log)\n"
+                 "  --offscreen renders N GL frames without a display (EGL), --dump=N writes\n"
+                 "  every N-th frame to frame_<number>.tga\n"
+                 "  --world streams the models listed in FILE around the camera\n"
+                 "  --snapshot starts from the scene saved in FILE, or saves the scene there\n"
+                 "  at exit if it can't be read\n"
+                 "  --state writes the ECS state of every headless frame to FILE, the first\n"
+                 "  frame in full and the changes after it\n"
+                 "  --verify-state replays the state of every headless frame into a second\n"
+                 "  registry and stops with an error if it differs"
+              << std::endl;
+}
+
+// the whole value must be a decimal number that fits in 32 bits
+bool ParseCount(char const * value, uint32_t & count)
+{
+    if(*value < '0' || *value > '9')
+        return false;
+
+    char * end = nullptr;
+    errno      = 0;
+
+    auto const parsed = std::strtoul(value, &end, 10);
+    if(*end != '\0' || errno == ERANGE || parsed > UINT32_MAX)
+        return false;
+
+    count = static_cast<uint32_t>(parsed);
+    return true;
+}
+}   // namespace
+
+int main(int argc, char * argv[])
+{
+    RenderBackend::Type backend_type  = RenderBackend::Type::GL;
+    bool                offscreen     = false;
+    uint32_t            num_frames    = 1000;
+    uint32_t            dump_interval = 0;
+    std::string         log_fname     = "render.log";
+    std::string         world_fname;
+    std::string         snapshot_fname;
+    std::string         state_fname;
+    bool                verify_state  = false;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string const arg = argv[i];
+
+        if(arg == "--backend=gl")
+            backend_type = RenderBackend::Type::GL;
+        else if(arg == "--backend=null")
+            backend_type = RenderBackend::Type::Null;
+        else if(arg == "--backend=record")
+            backend_type = RenderBackend::Type::Recording;
+        else if(arg == "--offscreen")
+            offscreen = true;
+        else if(arg.rfind("--frames=", 0) == 0)
+        {
+            if(!ParseCount(arg.c_str() + 9, num_frames) || num_frames == 0)
+            {
+                std::cout << "Invalid frame count " << arg.substr(9) << std::endl;
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if(arg.rfind("--dump=", 0) == 0)
+        {
+            if(!ParseCount(arg.c_str() + 7, dump_interval))
+            {
+                std::cout << "Invalid dump interval " << arg.substr(7) << std::endl;
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if(arg.rfind("--log=", 0) == 0)
+            log_fname = arg.substr(6);
+        else if(arg.rfind("--world=", 0) == 0)
+            world_fname = arg.substr(8);
+        else if(arg.rfind("--snapshot=", 0) == 0)
+            snapshot_fname = arg.substr(11);
+        else if(arg.rfind("--state=", 0) == 0)
+            state_fname = arg.substr(8);
+        else if(arg == "--verify-state")
+            verify_state = true;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::ofstream log;
+    if(backend_type == RenderBackend::Type::Recording)
+    {
+        log.open(log_fname);
+        if(!log)
+        {
+            std::cout << "Failed to open the render log " << log_fname << std::endl;
+            PrintUsage();
+            return 1;
+        }
+    }
+
     try
     {
-        Window w{800, 600, "Entity test"};
+        Window w{800, 600, "Entity test", CreateRenderBackend(backend_type, &log), offscreen, snapshot_fname};
         w.create();
         w.initScene();
-        w.run();
+        if(!world_fname.empty())
+            w.loadWorld(world_fname);
+        if(w.isHeadless())
+            w.runHeadless(num_frames, dump_interval, state_fname, verify_state);
+        else
+            w.run();
+
+        if(!snapshot_fname.empty() && !w.isRestored() && !w.saveSnapshot(snapshot_fname))
+            std::cout << "Failed to write the snapshot " << snapshot_fname << std::endl;
     }
     catch(std::exception const & e)
     {
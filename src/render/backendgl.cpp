@@ -0,0 +1,289 @@
+#include "backendgl.h"
+#include <GL/glew.h>
+
+bool GLBackend::hasMapBufferRange() const
+{
+    return GLEW_ARB_map_buffer_range == GL_TRUE;
+}
+
+bool GLBackend::hasSync() const
+{
+    return GLEW_ARB_sync == GL_TRUE;
+}
+
+void GLBackend::enable(uint32_t cap)
+{
+    glEnable(cap);
+}
+
+void GLBackend::disable(uint32_t cap)
+{
+    glDisable(cap);
+}
+
+void GLBackend::enableClientState(uint32_t array)
+{
+    glEnableClientState(array);
+}
+
+void GLBackend::disableClientState(uint32_t array)
+{
+    glDisableClientState(array);
+}
+
+void GLBackend::hint(uint32_t target, uint32_t mode)
+{
+    glHint(target, mode);
+}
+
+void GLBackend::shadeModel(uint32_t mode)
+{
+    glShadeModel(mode);
+}
+
+void GLBackend::viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    glViewport(x, y, width, height);
+}
+
+void GLBackend::polygonOffset(float factor, float units)
+{
+    glPolygonOffset(factor, units);
+}
+
+void GLBackend::polygonMode(uint32_t face, uint32_t mode)
+{
+    glPolygonMode(face, mode);
+}
+
+void GLBackend::lineWidth(float width)
+{
+    glLineWidth(width);
+}
+
+void GLBackend::blendFunc(uint32_t src, uint32_t dst)
+{
+    glBlendFunc(src, dst);
+}
+
+void GLBackend::blendColor(float r, float g, float b, float a)
+{
+    glBlendColor(r, g, b, a);
+}
+
+void GLBackend::alphaFunc(uint32_t func, float ref)
+{
+    glAlphaFunc(func, ref);
+}
+
+void GLBackend::frontFace(uint32_t mode)
+{
+    glFrontFace(mode);
+}
+
+void GLBackend::cullFace(uint32_t mode)
+{
+    glCullFace(mode);
+}
+
+void GLBackend::depthFunc(uint32_t func)
+{
+    glDepthFunc(func);
+}
+
+void GLBackend::depthMask(bool flag)
+{
+    glDepthMask(flag ? GL_TRUE : GL_FALSE);
+}
+
+void GLBackend::stencilFunc(uint32_t func, int32_t ref, uint32_t mask)
+{
+    glStencilFunc(func, ref, mask);
+}
+
+void GLBackend::stencilMask(uint32_t mask)
+{
+    glStencilMask(mask);
+}
+
+void GLBackend::stencilOp(uint32_t fail, uint32_t z_fail, uint32_t z_pass)
+{
+    glStencilOp(fail, z_fail, z_pass);
+}
+
+void GLBackend::clearColor(float r, float g, float b, float a)
+{
+    glClearColor(r, g, b, a);
+}
+
+void GLBackend::clearDepth(double depth)
+{
+    glClearDepth(depth);
+}
+
+void GLBackend::clearStencil(int32_t s)
+{
+    glClearStencil(s);
+}
+
+void GLBackend::clear(uint32_t mask)
+{
+    glClear(mask);
+}
+
+void GLBackend::matrixMode(uint32_t mode)
+{
+    glMatrixMode(mode);
+}
+
+void GLBackend::loadMatrix(float const * m)
+{
+    glLoadMatrixf(m);
+}
+
+void GLBackend::loadIdentity()
+{
+    glLoadIdentity();
+}
+
+void GLBackend::multMatrix(float const * m)
+{
+    glMultMatrixf(m);
+}
+
+void GLBackend::pushMatrix()
+{
+    glPushMatrix();
+}
+
+void GLBackend::popMatrix()
+{
+    glPopMatrix();
+}
+
+void GLBackend::color3f(float r, float g, float b)
+{
+    glColor3f(r, g, b);
+}
+
+void GLBackend::materialfv(uint32_t face, uint32_t pname, float const * params)
+{
+    glMaterialfv(face, pname, params);
+}
+
+void GLBackend::materialf(uint32_t face, uint32_t pname, float param)
+{
+    glMaterialf(face, pname, param);
+}
+
+void GLBackend::lightfv(uint32_t light, uint32_t pname, float const * params)
+{
+    glLightfv(light, pname, params);
+}
+
+void GLBackend::lightf(uint32_t light, uint32_t pname, float param)
+{
+    glLightf(light, pname, param);
+}
+
+void GLBackend::genBuffers(int32_t n, uint32_t * buffers)
+{
+    glGenBuffers(n, buffers);
+}
+
+void GLBackend::deleteBuffers(int32_t n, uint32_t const * buffers)
+{
+    glDeleteBuffers(n, buffers);
+}
+
+void GLBackend::bindBuffer(uint32_t target, uint32_t buffer)
+{
+    glBindBuffer(target, buffer);
+}
+
+void GLBackend::bufferData(uint32_t target, size_t size, void const * data, uint32_t usage)
+{
+    glBufferData(target, static_cast<GLsizeiptr>(size), data, usage);
+}
+
+void GLBackend::bufferSubData(uint32_t target, size_t offset, size_t size, void const * data)
+{
+    glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+}
+
+void * GLBackend::mapBuffer(uint32_t target, uint32_t access)
+{
+    return glMapBuffer(target, access);
+}
+
+void * GLBackend::mapBufferRange(uint32_t target, size_t offset, size_t length, uint32_t access)
+{
+    return glMapBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(length), access);
+}
+
+bool GLBackend::unmapBuffer(uint32_t target)
+{
+    return glUnmapBuffer(target) == GL_TRUE;
+}
+
+void GLBackend::genTextures(int32_t n, uint32_t * textures)
+{
+    glGenTextures(n, textures);
+}
+
+void GLBackend::deleteTextures(int32_t n, uint32_t const * textures)
+{
+    glDeleteTextures(n, textures);
+}
+
+void GLBackend::bindTexture(uint32_t target, uint32_t texture)
+{
+    glBindTexture(target, texture);
+}
+
+void GLBackend::texParameteri(uint32_t target, uint32_t pname, int32_t param)
+{
+    glTexParameteri(target, pname, param);
+}
+
+void GLBackend::texImage2D(uint32_t target, int32_t level, int32_t internal_format, int32_t width,
+                           int32_t height, int32_t border, uint32_t format, uint32_t type,
+                           void const * pixels)
+{
+    glTexImage2D(target, level, internal_format, width, height, border, format, type, pixels);
+}
+
+void GLBackend::vertexPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr)
+{
+    glVertexPointer(size, type, stride, ptr);
+}
+
+void GLBackend::normalPointer(uint32_t type, int32_t stride, void const * ptr)
+{
+    glNormalPointer(type, stride, ptr);
+}
+
+void GLBackend::texCoordPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr)
+{
+    glTexCoordPointer(size, type, stride, ptr);
+}
+
+void GLBackend::drawElements(uint32_t mode, int32_t count, uint32_t type, void const * indices)
+{
+    glDrawElements(mode, count, type, indices);
+}
+
+void * GLBackend::fenceSync()
+{
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GLBackend::clientWaitSync(void * handle)
+{
+    glClientWaitSync(static_cast<GLsync>(handle), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+}
+
+void GLBackend::deleteSync(void * handle)
+{
+    glDeleteSync(static_cast<GLsync>(handle));
+}
@@ -0,0 +1,80 @@
+#ifndef BACKENDGL_H
+#define BACKENDGL_H
+
+#include "renderbackend.h"
+
+// forwards to the current GL context
+class GLBackend : public RenderBackend
+{
+public:
+    GLBackend() = default;
+
+    bool needsContext() const override { return true; }
+    bool hasMapBufferRange() const override;
+    bool hasSync() const override;
+
+    void enable(uint32_t cap) override;
+    void disable(uint32_t cap) override;
+    void enableClientState(uint32_t array) override;
+    void disableClientState(uint32_t array) override;
+    void hint(uint32_t target, uint32_t mode) override;
+    void shadeModel(uint32_t mode) override;
+    void viewport(int32_t x, int32_t y, int32_t width, int32_t height) override;
+    void polygonOffset(float factor, float units) override;
+    void polygonMode(uint32_t face, uint32_t mode) override;
+    void lineWidth(float width) override;
+    void blendFunc(uint32_t src, uint32_t dst) override;
+    void blendColor(float r, float g, float b, float a) override;
+    void alphaFunc(uint32_t func, float ref) override;
+    void frontFace(uint32_t mode) override;
+    void cullFace(uint32_t mode) override;
+    void depthFunc(uint32_t func) override;
+    void depthMask(bool flag) override;
+    void stencilFunc(uint32_t func, int32_t ref, uint32_t mask) override;
+    void stencilMask(uint32_t mask) override;
+    void stencilOp(uint32_t fail, uint32_t z_fail, uint32_t z_pass) override;
+
+    void clearColor(float r, float g, float b, float a) override;
+    void clearDepth(double depth) override;
+    void clearStencil(int32_t s) override;
+    void clear(uint32_t mask) override;
+
+    void matrixMode(uint32_t mode) override;
+    void loadMatrix(float const * m) override;
+    void loadIdentity() override;
+    void multMatrix(float const * m) override;
+    void pushMatrix() override;
+    void popMatrix() override;
+    void color3f(float r, float g, float b) override;
+    void materialfv(uint32_t face, uint32_t pname, float const * params) override;
+    void materialf(uint32_t face, uint32_t pname, float param) override;
+    void lightfv(uint32_t light, uint32_t pname, float const * params) override;
+    void lightf(uint32_t light, uint32_t pname, float param) override;
+
+    void   genBuffers(int32_t n, uint32_t * buffers) override;
+    void   deleteBuffers(int32_t n, uint32_t const * buffers) override;
+    void   bindBuffer(uint32_t target, uint32_t buffer) override;
+    void   bufferData(uint32_t target, size_t size, void const * data, uint32_t usage) override;
+    void   bufferSubData(uint32_t target, size_t offset, size_t size, void const * data) override;
+    void * mapBuffer(uint32_t target, uint32_t access) override;
+    void * mapBufferRange(uint32_t target, size_t offset, size_t length, uint32_t access) override;
+    bool   unmapBuffer(uint32_t target) override;
+
+    void genTextures(int32_t n, uint32_t * textures) override;
+    void deleteTextures(int32_t n, uint32_t const * textures) override;
+    void bindTexture(uint32_t target, uint32_t texture) override;
+    void texParameteri(uint32_t target, uint32_t pname, int32_t param) override;
+    void texImage2D(uint32_t target, int32_t level, int32_t internal_format, int32_t width, int32_t height,
+                    int32_t border, uint32_t format, uint32_t type, void const * pixels) override;
+
+    void vertexPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr) override;
+    void normalPointer(uint32_t type, int32_t stride, void const * ptr) override;
+    void texCoordPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr) override;
+    void drawElements(uint32_t mode, int32_t count, uint32_t type, void const * indices) override;
+
+    void * fenceSync() override;
+    void   clientWaitSync(void * handle) override;
+    void   deleteSync(void * handle) override;
+};
+
+#endif   // BACKENDGL_H
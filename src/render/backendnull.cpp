@@ -0,0 +1,551 @@
+#include "backendnull.h"
+#include <GL/glew.h>
+#include <cstring>
+#include <iomanip>
+
+namespace
+{
+// argument wrappers for the log
+struct Enum
+{
+    uint32_t value;
+};
+
+struct Floats
+{
+    float const * values;
+    uint32_t      count;
+};
+
+struct Ptr
+{
+    void const * ptr;
+};
+
+struct Bits
+{
+    uint32_t value;
+};
+
+// client memory, the address isn't logged to keep the logs comparable
+struct Data
+{
+    void const * ptr;
+};
+
+#define GL_ENUM_NAME(e) {e, #e}
+
+char const * EnumName(uint32_t value)
+{
+    // only values that can't be confused with a count or a bit mask
+    static std::unordered_map<uint32_t, char const *> const names = {
+        GL_ENUM_NAME(GL_NEVER),
+        GL_ENUM_NAME(GL_LESS),
+        GL_ENUM_NAME(GL_EQUAL),
+        GL_ENUM_NAME(GL_LEQUAL),
+        GL_ENUM_NAME(GL_GREATER),
+        GL_ENUM_NAME(GL_NOTEQUAL),
+        GL_ENUM_NAME(GL_GEQUAL),
+        GL_ENUM_NAME(GL_ALWAYS),
+        GL_ENUM_NAME(GL_SRC_COLOR),
+        GL_ENUM_NAME(GL_ONE_MINUS_SRC_COLOR),
+        GL_ENUM_NAME(GL_SRC_ALPHA),
+        GL_ENUM_NAME(GL_ONE_MINUS_SRC_ALPHA),
+        GL_ENUM_NAME(GL_DST_ALPHA),
+        GL_ENUM_NAME(GL_ONE_MINUS_DST_ALPHA),
+        GL_ENUM_NAME(GL_DST_COLOR),
+        GL_ENUM_NAME(GL_ONE_MINUS_DST_COLOR),
+        GL_ENUM_NAME(GL_SRC_ALPHA_SATURATE),
+        GL_ENUM_NAME(GL_FRONT),
+        GL_ENUM_NAME(GL_BACK),
+        GL_ENUM_NAME(GL_FRONT_AND_BACK),
+        GL_ENUM_NAME(GL_CCW),
+        GL_ENUM_NAME(GL_CULL_FACE),
+        GL_ENUM_NAME(GL_LIGHTING),
+        GL_ENUM_NAME(GL_DEPTH_TEST),
+        GL_ENUM_NAME(GL_STENCIL_TEST),
+        GL_ENUM_NAME(GL_ALPHA_TEST),
+        GL_ENUM_NAME(GL_BLEND),
+        GL_ENUM_NAME(GL_NORMALIZE),
+        GL_ENUM_NAME(GL_TEXTURE_2D),
+        GL_ENUM_NAME(GL_POLYGON_OFFSET_FILL),
+        GL_ENUM_NAME(GL_POLYGON_OFFSET_LINE),
+        GL_ENUM_NAME(GL_POLYGON_OFFSET_POINT),
+        GL_ENUM_NAME(GL_LIGHT0),
+        GL_ENUM_NAME(GL_LIGHT1),
+        GL_ENUM_NAME(GL_LIGHT2),
+        GL_ENUM_NAME(GL_LIGHT3),
+        GL_ENUM_NAME(GL_LIGHT4),
+        GL_ENUM_NAME(GL_LIGHT5),
+        GL_ENUM_NAME(GL_LIGHT6),
+        GL_ENUM_NAME(GL_LIGHT7),
+        GL_ENUM_NAME(GL_AMBIENT),
+        GL_ENUM_NAME(GL_DIFFUSE),
+        GL_ENUM_NAME(GL_SPECULAR),
+        GL_ENUM_NAME(GL_POSITION),
+        GL_ENUM_NAME(GL_SPOT_DIRECTION),
+        GL_ENUM_NAME(GL_SPOT_EXPONENT),
+        GL_ENUM_NAME(GL_SPOT_CUTOFF),
+        GL_ENUM_NAME(GL_CONSTANT_ATTENUATION),
+        GL_ENUM_NAME(GL_LINEAR_ATTENUATION),
+        GL_ENUM_NAME(GL_QUADRATIC_ATTENUATION),
+        GL_ENUM_NAME(GL_SHININESS),
+        GL_ENUM_NAME(GL_MODELVIEW),
+        GL_ENUM_NAME(GL_PROJECTION),
+        GL_ENUM_NAME(GL_SMOOTH),
+        GL_ENUM_NAME(GL_PERSPECTIVE_CORRECTION_HINT),
+        GL_ENUM_NAME(GL_NICEST),
+        GL_ENUM_NAME(GL_LINE),
+        GL_ENUM_NAME(GL_FILL),
+        GL_ENUM_NAME(GL_KEEP),
+        GL_ENUM_NAME(GL_REPLACE),
+        GL_ENUM_NAME(GL_INCR),
+        GL_ENUM_NAME(GL_DECR),
+        GL_ENUM_NAME(GL_INVERT),
+        GL_ENUM_NAME(GL_VERTEX_ARRAY),
+        GL_ENUM_NAME(GL_NORMAL_ARRAY),
+        GL_ENUM_NAME(GL_TEXTURE_COORD_ARRAY),
+        GL_ENUM_NAME(GL_UNSIGNED_BYTE),
+        GL_ENUM_NAME(GL_UNSIGNED_SHORT),
+        GL_ENUM_NAME(GL_UNSIGNED_INT),
+        GL_ENUM_NAME(GL_FLOAT),
+        GL_ENUM_NAME(GL_RGB),
+        GL_ENUM_NAME(GL_RGBA),
+        GL_ENUM_NAME(GL_LINEAR),
+        GL_ENUM_NAME(GL_TEXTURE_MAG_FILTER),
+        GL_ENUM_NAME(GL_TEXTURE_MIN_FILTER),
+        GL_ENUM_NAME(GL_ARRAY_BUFFER),
+        GL_ENUM_NAME(GL_ELEMENT_ARRAY_BUFFER),
+        GL_ENUM_NAME(GL_STREAM_DRAW),
+        GL_ENUM_NAME(GL_STATIC_DRAW),
+        GL_ENUM_NAME(GL_WRITE_ONLY),
+    };
+
+    auto it = names.find(value);
+
+    return it != names.end() ? it->second : nullptr;
+}
+
+#undef GL_ENUM_NAME
+
+char const * PrimitiveName(uint32_t mode)
+{
+    switch(mode)
+    {
+        case GL_LINES:
+            return "GL_LINES";
+        case GL_LINE_LOOP:
+            return "GL_LINE_LOOP";
+        case GL_TRIANGLES:
+            return "GL_TRIANGLES";
+        default:
+            return "?";
+    }
+}
+
+std::ostream & operator<<(std::ostream & out, Bits b)
+{
+    return out << "0x" << std::hex << b.value << std::dec;
+}
+
+std::ostream & operator<<(std::ostream & out, Enum e)
+{
+    char const * name = EnumName(e.value);
+    if(name != nullptr)
+        return out << name;
+
+    return out << Bits{e.value};
+}
+
+std::ostream & operator<<(std::ostream & out, Floats f)
+{
+    out << '{';
+    for(uint32_t i = 0; i < f.count; ++i)
+        out << (i > 0 ? ", " : "") << f.values[i];
+
+    return out << '}';
+}
+
+std::ostream & operator<<(std::ostream & out, Ptr p)
+{
+    if(p.ptr == nullptr)
+        return out << "nullptr";
+
+    return out << "0x" << std::hex << reinterpret_cast<uintptr_t>(p.ptr) << std::dec;
+}
+
+std::ostream & operator<<(std::ostream & out, Data d)
+{
+    return out << (d.ptr != nullptr ? "data" : "nullptr");
+}
+
+uint32_t LightParamCount(uint32_t pname)
+{
+    return pname == GL_SPOT_DIRECTION ? 3 : 4;
+}
+
+uint32_t PixelSize(uint32_t format)
+{
+    return format == GL_RGB ? 3 : 4;
+}
+}   // namespace
+
+void NullBackend::endFrame()
+{
+    m_stats.frames++;
+    if(m_log != nullptr)
+        *m_log << "# end of frame " << m_stats.frames << '\n';
+}
+
+void NullBackend::enable(uint32_t cap)
+{
+    trace("glEnable", Enum{cap});
+}
+
+void NullBackend::disable(uint32_t cap)
+{
+    trace("glDisable", Enum{cap});
+}
+
+void NullBackend::enableClientState(uint32_t array)
+{
+    trace("glEnableClientState", Enum{array});
+}
+
+void NullBackend::disableClientState(uint32_t array)
+{
+    trace("glDisableClientState", Enum{array});
+}
+
+void NullBackend::hint(uint32_t target, uint32_t mode)
+{
+    trace("glHint", Enum{target}, Enum{mode});
+}
+
+void NullBackend::shadeModel(uint32_t mode)
+{
+    trace("glShadeModel", Enum{mode});
+}
+
+void NullBackend::viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    trace("glViewport", x, y, width, height);
+}
+
+void NullBackend::polygonOffset(float factor, float units)
+{
+    trace("glPolygonOffset", factor, units);
+}
+
+void NullBackend::polygonMode(uint32_t face, uint32_t mode)
+{
+    trace("glPolygonMode", Enum{face}, Enum{mode});
+}
+
+void NullBackend::lineWidth(float width)
+{
+    trace("glLineWidth", width);
+}
+
+void NullBackend::blendFunc(uint32_t src, uint32_t dst)
+{
+    trace("glBlendFunc", Enum{src}, Enum{dst});
+}
+
+void NullBackend::blendColor(float r, float g, float b, float a)
+{
+    trace("glBlendColor", r, g, b, a);
+}
+
+void NullBackend::alphaFunc(uint32_t func, float ref)
+{
+    trace("glAlphaFunc", Enum{func}, ref);
+}
+
+void NullBackend::frontFace(uint32_t mode)
+{
+    trace("glFrontFace", Enum{mode});
+}
+
+void NullBackend::cullFace(uint32_t mode)
+{
+    trace("glCullFace", Enum{mode});
+}
+
+void NullBackend::depthFunc(uint32_t func)
+{
+    trace("glDepthFunc", Enum{func});
+}
+
+void NullBackend::depthMask(bool flag)
+{
+    trace("glDepthMask", flag ? "GL_TRUE" : "GL_FALSE");
+}
+
+void NullBackend::stencilFunc(uint32_t func, int32_t ref, uint32_t mask)
+{
+    trace("glStencilFunc", Enum{func}, ref, mask);
+}
+
+void NullBackend::stencilMask(uint32_t mask)
+{
+    trace("glStencilMask", mask);
+}
+
+void NullBackend::stencilOp(uint32_t fail, uint32_t z_fail, uint32_t z_pass)
+{
+    trace("glStencilOp", Enum{fail}, Enum{z_fail}, Enum{z_pass});
+}
+
+void NullBackend::clearColor(float r, float g, float b, float a)
+{
+    trace("glClearColor", r, g, b, a);
+}
+
+void NullBackend::clearDepth(double depth)
+{
+    trace("glClearDepth", depth);
+}
+
+void NullBackend::clearStencil(int32_t s)
+{
+    trace("glClearStencil", s);
+}
+
+void NullBackend::clear(uint32_t mask)
+{
+    trace("glClear", Bits{mask});
+}
+
+void NullBackend::matrixMode(uint32_t mode)
+{
+    trace("glMatrixMode", Enum{mode});
+}
+
+void NullBackend::loadMatrix(float const * m)
+{
+    trace("glLoadMatrixf", Floats{m, 16});
+}
+
+void NullBackend::loadIdentity()
+{
+    trace("glLoadIdentity");
+}
+
+void NullBackend::multMatrix(float const * m)
+{
+    trace("glMultMatrixf", Floats{m, 16});
+}
+
+void NullBackend::pushMatrix()
+{
+    trace("glPushMatrix");
+}
+
+void NullBackend::popMatrix()
+{
+    trace("glPopMatrix");
+}
+
+void NullBackend::color3f(float r, float g, float b)
+{
+    trace("glColor3f", r, g, b);
+}
+
+void NullBackend::materialfv(uint32_t face, uint32_t pname, float const * params)
+{
+    trace("glMaterialfv", Enum{face}, Enum{pname}, Floats{params, 4});
+}
+
+void NullBackend::materialf(uint32_t face, uint32_t pname, float param)
+{
+    trace("glMaterialf", Enum{face}, Enum{pname}, param);
+}
+
+void NullBackend::lightfv(uint32_t light, uint32_t pname, float const * params)
+{
+    trace("glLightfv", Enum{light}, Enum{pname}, Floats{params, LightParamCount(pname)});
+}
+
+void NullBackend::lightf(uint32_t light, uint32_t pname, float param)
+{
+    trace("glLightf", Enum{light}, Enum{pname}, param);
+}
+
+void NullBackend::genBuffers(int32_t n, uint32_t * buffers)
+{
+    for(int32_t i = 0; i < n; ++i)
+    {
+        buffers[i] = m_next_buffer++;
+        m_buffers[buffers[i]];
+    }
+
+    trace("glGenBuffers", n, n > 0 ? buffers[0] : 0);
+}
+
+void NullBackend::deleteBuffers(int32_t n, uint32_t const * buffers)
+{
+    for(int32_t i = 0; i < n; ++i)
+    {
+        m_buffers.erase(buffers[i]);
+        if(m_array_buffer == buffers[i])
+            m_array_buffer = 0;
+        if(m_element_buffer == buffers[i])
+            m_element_buffer = 0;
+    }
+
+    trace("glDeleteBuffers", n, n > 0 ? buffers[0] : 0);
+}
+
+void NullBackend::bindBuffer(uint32_t target, uint32_t buffer)
+{
+    binding(target) = buffer;
+    trace("glBindBuffer", Enum{target}, buffer);
+}
+
+void NullBackend::bufferData(uint32_t target, size_t size, void const * data, uint32_t usage)
+{
+    auto & storage = m_buffers[binding(target)];
+
+    storage.resize(size);
+    if(data != nullptr)
+    {
+        std::memcpy(storage.data(), data, size);
+        m_stats.buffer_bytes += size;
+    }
+
+    trace("glBufferData", Enum{target}, size, Data{data}, Enum{usage});
+}
+
+void NullBackend::bufferSubData(uint32_t target, size_t offset, size_t size, void const * data)
+{
+    auto & storage = m_buffers[binding(target)];
+
+    if(offset + size <= storage.size())
+    {
+        std::memcpy(storage.data() + offset, data, size);
+        m_stats.buffer_bytes += size;
+    }
+
+    trace("glBufferSubData", Enum{target}, offset, size, Data{data});
+}
+
+void * NullBackend::mapBuffer(uint32_t target, uint32_t access)
+{
+    auto & storage = m_buffers[binding(target)];
+
+    m_stats.mapped_bytes += storage.size();
+    trace("glMapBuffer", Enum{target}, Enum{access});
+
+    return storage.empty() ? nullptr : storage.data();
+}
+
+void * NullBackend::mapBufferRange(uint32_t target, size_t offset, size_t length, uint32_t access)
+{
+    auto & storage = m_buffers[binding(target)];
+
+    trace("glMapBufferRange", Enum{target}, offset, length, Bits{access});
+    if(length == 0 || offset + length > storage.size())
+        return nullptr;
+
+    m_stats.mapped_bytes += length;
+
+    return storage.data() + offset;
+}
+
+bool NullBackend::unmapBuffer(uint32_t target)
+{
+    trace("glUnmapBuffer", Enum{target});
+
+    return true;
+}
+
+void NullBackend::genTextures(int32_t n, uint32_t * textures)
+{
+    for(int32_t i = 0; i < n; ++i)
+        textures[i] = m_next_texture++;
+
+    trace("glGenTextures", n, n > 0 ? textures[0] : 0);
+}
+
+void NullBackend::deleteTextures(int32_t n, uint32_t const * textures)
+{
+    trace("glDeleteTextures", n, n > 0 ? textures[0] : 0);
+}
+
+void NullBackend::bindTexture(uint32_t target, uint32_t texture)
+{
+    trace("glBindTexture", Enum{target}, texture);
+}
+
+void NullBackend::texParameteri(uint32_t target, uint32_t pname, int32_t param)
+{
+    trace("glTexParameteri", Enum{target}, Enum{pname}, Enum{static_cast<uint32_t>(param)});
+}
+
+void NullBackend::texImage2D(uint32_t target, int32_t level, int32_t internal_format, int32_t width,
+                             int32_t height, int32_t border, uint32_t format, uint32_t type,
+                             void const * pixels)
+{
+    if(pixels != nullptr)
+    {
+        uint64_t const pixel_count = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+
+        m_stats.texture_bytes += pixel_count * PixelSize(format);
+    }
+
+    trace("glTexImage2D", Enum{target}, level, internal_format, width, height, border, Enum{format},
+          Enum{type}, Data{pixels});
+}
+
+void NullBackend::vertexPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr)
+{
+    trace("glVertexPointer", size, Enum{type}, stride, Ptr{ptr});
+}
+
+void NullBackend::normalPointer(uint32_t type, int32_t stride, void const * ptr)
+{
+    trace("glNormalPointer", Enum{type}, stride, Ptr{ptr});
+}
+
+void NullBackend::texCoordPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr)
+{
+    trace("glTexCoordPointer", size, Enum{type}, stride, Ptr{ptr});
+}
+
+void NullBackend::drawElements(uint32_t mode, int32_t count, uint32_t type, void const * indices)
+{
+    m_stats.draw_calls++;
+    m_stats.indices += static_cast<uint64_t>(count);
+
+    trace("glDrawElements", PrimitiveName(mode), count, Enum{type}, Ptr{indices});
+}
+
+void * NullBackend::fenceSync()
+{
+    void * handle = reinterpret_cast<void *>(static_cast<uintptr_t>(m_next_sync++));
+
+    trace("glFenceSync", Ptr{handle});
+
+    return handle;
+}
+
+void NullBackend::clientWaitSync(void * handle)
+{
+    trace("glClientWaitSync", Ptr{handle});
+}
+
+void NullBackend::deleteSync(void * handle)
+{
+    trace("glDeleteSync", Ptr{handle});
+}
+
+uint32_t & NullBackend::binding(uint32_t target)
+{
+    if(target == GL_ARRAY_BUFFER)
+        return m_array_buffer;
+    if(target == GL_ELEMENT_ARRAY_BUFFER)
+        return m_element_buffer;
+
+    return m_other_buffer;
+}
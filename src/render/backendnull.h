@@ -0,0 +1,124 @@
+#ifndef BACKENDNULL_H
+#define BACKENDNULL_H
+
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "renderbackend.h"
+
+// Headless backend, no GL calls. Object names are generated, buffer contents
+// are kept in system memory so mapped pointers stay valid and the CPU cost of
+// filling them is measured.
+class NullBackend : public RenderBackend
+{
+public:
+    NullBackend() = default;
+
+    bool needsContext() const override { return false; }
+    bool hasMapBufferRange() const override { return true; }
+    bool hasSync() const override { return true; }
+
+    void endFrame() override;
+
+    void enable(uint32_t cap) override;
+    void disable(uint32_t cap) override;
+    void enableClientState(uint32_t array) override;
+    void disableClientState(uint32_t array) override;
+    void hint(uint32_t target, uint32_t mode) override;
+    void shadeModel(uint32_t mode) override;
+    void viewport(int32_t x, int32_t y, int32_t width, int32_t height) override;
+    void polygonOffset(float factor, float units) override;
+    void polygonMode(uint32_t face, uint32_t mode) override;
+    void lineWidth(float width) override;
+    void blendFunc(uint32_t src, uint32_t dst) override;
+    void blendColor(float r, float g, float b, float a) override;
+    void alphaFunc(uint32_t func, float ref) override;
+    void frontFace(uint32_t mode) override;
+    void cullFace(uint32_t mode) override;
+    void depthFunc(uint32_t func) override;
+    void depthMask(bool flag) override;
+    void stencilFunc(uint32_t func, int32_t ref, uint32_t mask) override;
+    void stencilMask(uint32_t mask) override;
+    void stencilOp(uint32_t fail, uint32_t z_fail, uint32_t z_pass) override;
+
+    void clearColor(float r, float g, float b, float a) override;
+    void clearDepth(double depth) override;
+    void clearStencil(int32_t s) override;
+    void clear(uint32_t mask) override;
+
+    void matrixMode(uint32_t mode) override;
+    void loadMatrix(float const * m) override;
+    void loadIdentity() override;
+    void multMatrix(float const * m) override;
+    void pushMatrix() override;
+    void popMatrix() override;
+    void color3f(float r, float g, float b) override;
+    void materialfv(uint32_t face, uint32_t pname, float const * params) override;
+    void materialf(uint32_t face, uint32_t pname, float param) override;
+    void lightfv(uint32_t light, uint32_t pname, float const * params) override;
+    void lightf(uint32_t light, uint32_t pname, float param) override;
+
+    void   genBuffers(int32_t n, uint32_t * buffers) override;
+    void   deleteBuffers(int32_t n, uint32_t const * buffers) override;
+    void   bindBuffer(uint32_t target, uint32_t buffer) override;
+    void   bufferData(uint32_t target, size_t size, void const * data, uint32_t usage) override;
+    void   bufferSubData(uint32_t target, size_t offset, size_t size, void const * data) override;
+    void * mapBuffer(uint32_t target, uint32_t access) override;
+    void * mapBufferRange(uint32_t target, size_t offset, size_t length, uint32_t access) override;
+    bool   unmapBuffer(uint32_t target) override;
+
+    void genTextures(int32_t n, uint32_t * textures) override;
+    void deleteTextures(int32_t n, uint32_t const * textures) override;
+    void bindTexture(uint32_t target, uint32_t texture) override;
+    void texParameteri(uint32_t target, uint32_t pname, int32_t param) override;
+    void texImage2D(uint32_t target, int32_t level, int32_t internal_format, int32_t width, int32_t height,
+                    int32_t border, uint32_t format, uint32_t type, void const * pixels) override;
+
+    void vertexPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr) override;
+    void normalPointer(uint32_t type, int32_t stride, void const * ptr) override;
+    void texCoordPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr) override;
+    void drawElements(uint32_t mode, int32_t count, uint32_t type, void const * indices) override;
+
+    void * fenceSync() override;
+    void   clientWaitSync(void * handle) override;
+    void   deleteSync(void * handle) override;
+
+protected:
+    template<typename... Args>
+    void trace(char const * name, Args const &... args)
+    {
+        m_stats.calls++;
+        if(m_log != nullptr)
+        {
+            *m_log << name << '(';
+            [[maybe_unused]] char const * sep = "";
+            ((*m_log << sep << args, sep = ", "), ...);
+            *m_log << ")\n";
+        }
+    }
+
+    std::ostream * m_log = nullptr;
+
+private:
+    uint32_t & binding(uint32_t target);
+
+    uint32_t m_next_buffer  = 1;
+    uint32_t m_next_texture = 1;
+    uint32_t m_next_sync    = 1;
+
+    uint32_t m_array_buffer   = 0;
+    uint32_t m_element_buffer = 0;
+    uint32_t m_other_buffer   = 0;   // targets the renderer doesn't use
+
+    std::unordered_map<uint32_t, std::vector<uint8_t>> m_buffers;
+};
+
+// null backend that writes every call with its arguments to the log
+class RecordingBackend : public NullBackend
+{
+public:
+    explicit RecordingBackend(std::ostream & log) { m_log = &log; }
+};
+
+#endif   // BACKENDNULL_H
@@ -0,0 +1,99 @@
+#include "bufferarena.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+bool BufferArena::allocate(uint32_t size, Range & range)
+{
+    if(size == 0)
+        return false;
+
+    for(auto & page : m_pages)
+    {
+        auto block = std::find_if(page.free_blocks.begin(), page.free_blocks.end(),
+                                  [size](Block const & blk) { return blk.size >= size; });
+        if(block == page.free_blocks.end())
+            continue;
+
+        range.buffer = page.buffer;
+        range.offset = block->offset;
+        range.size   = size;
+
+        if(block->size == size)
+        {
+            page.free_blocks.erase(block);
+        }
+        else
+        {
+            block->offset += size;
+            block->size -= size;
+        }
+
+        m_used += size;
+
+        return true;
+    }
+
+    return false;
+}
+
+void BufferArena::free(Range const & range)
+{
+    if(range.size == 0)
+        return;
+
+    auto page = std::find_if(m_pages.begin(), m_pages.end(),
+                             [&range](Page const & pg) { return pg.buffer == range.buffer; });
+    assert(page != m_pages.end());
+    if(page == m_pages.end())
+        return;
+
+    auto & blocks = page->free_blocks;
+    auto   next   = std::lower_bound(blocks.begin(), blocks.end(), range.offset,
+                                 [](Block const & blk, uint32_t offset) { return blk.offset < offset; });
+
+    // merge with the neighbours
+    bool const join_prev =
+        next != blocks.begin() && std::prev(next)->offset + std::prev(next)->size == range.offset;
+    bool const join_next = next != blocks.end() && range.offset + range.size == next->offset;
+
+    if(join_prev && join_next)
+    {
+        std::prev(next)->size += range.size + next->size;
+        blocks.erase(next);
+    }
+    else if(join_prev)
+    {
+        std::prev(next)->size += range.size;
+    }
+    else if(join_next)
+    {
+        next->offset = range.offset;
+        next->size += range.size;
+    }
+    else
+    {
+        blocks.insert(next, {range.offset, range.size});
+    }
+
+    m_used -= range.size;
+}
+
+void BufferArena::addPage(uint32_t buffer, uint32_t size)
+{
+    m_pages.push_back({buffer, size, {{0, size}}});
+    m_capacity += size;
+}
+
+std::vector<uint32_t> BufferArena::clear()
+{
+    std::vector<uint32_t> buffers;
+    for(auto const & page : m_pages)
+        buffers.push_back(page.buffer);
+
+    m_pages.clear();
+    m_capacity = 0;
+    m_used     = 0;
+
+    return buffers;
+}
@@ -0,0 +1,60 @@
+#ifndef BUFFERARENA_H
+#define BUFFERARENA_H
+
+#include <cstdint>
+#include <vector>
+
+// Suballocates ranges from a few large GL buffers (pages) with a first fit
+// free list per page. Only the bookkeeping lives here, the renderer creates
+// the pages and uploads the data. Sizes are expected to be multiples of the
+// element size so every offset stays aligned to it.
+class BufferArena
+{
+public:
+    struct Range
+    {
+        uint32_t buffer = 0;
+        uint32_t offset = 0;   // bytes
+        uint32_t size   = 0;
+    };
+
+    BufferArena(uint32_t page_size) : m_page_size(page_size) {}
+
+    // false if no page has a free block of that size, add a page and retry
+    bool allocate(uint32_t size, Range & range);
+    void free(Range const & range);
+
+    // allocations bigger than a page get a page of their own
+    uint32_t getPageSize(uint32_t alloc_size) const
+    {
+        return alloc_size > m_page_size ? alloc_size : m_page_size;
+    }
+    void     addPage(uint32_t buffer, uint32_t size);
+    // forgets all pages and returns their buffers for deletion
+    std::vector<uint32_t> clear();
+
+    uint32_t getNumPages() const { return static_cast<uint32_t>(m_pages.size()); }
+    uint64_t getCapacity() const { return m_capacity; }
+    uint64_t getUsed() const { return m_used; }
+
+private:
+    struct Block
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct Page
+    {
+        uint32_t           buffer;
+        uint32_t           size;
+        std::vector<Block> free_blocks;   // sorted by offset, never adjacent
+    };
+
+    uint32_t          m_page_size;
+    std::vector<Page> m_pages;
+    uint64_t          m_capacity = 0;
+    uint64_t          m_used     = 0;
+};
+
+#endif   // BUFFERARENA_H
@@ -0,0 +1,17 @@
+#include "commandbuffer.h"
+#include "../scene/material.h"
+
+void CommandBuffer::bindMaterial(MaterialComponent const & mat)
+{
+    push(cmd::BindMaterial{mat.m_ambient, mat.m_diffuse, mat.m_specular, mat.m_shininess, mat.m_base_tex_id});
+}
+
+void CommandBuffer::drawModel(RenderModel const & mdl, uint32_t lod)
+{
+    auto const num_meshes = static_cast<uint32_t>(mdl.model.size()) / mdl.m_num_lods;
+
+    push(cmd::DrawModel{mdl.m_vertexbuffer, mdl.m_elementbuffer, mdl.m_stream_offset, mdl.m_index_width,
+                        num_meshes});
+
+    writeBytes(mdl.model.data() + lod * num_meshes, num_meshes * sizeof(RenderModel::mesh));
+}
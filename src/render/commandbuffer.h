@@ -0,0 +1,195 @@
+#ifndef COMMANDBUFFER_H
+#define COMMANDBUFFER_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "renderer.h"
+#include "../scene/light.h"
+
+struct MaterialComponent;
+
+// Draw packets, every packet is a trivially copyable struct written into the
+// command buffer after its type byte. Packets carry copies of everything the
+// backend needs, replay never reads the registry.
+namespace cmd
+{
+enum class Type : uint8_t
+{
+    Clear,
+    SetMatrix,
+    LoadIdentity,
+    Lighting,
+    BindLight,
+    UnbindLight,
+    BindMaterial,
+    DrawModel,
+    DrawBBox
+};
+
+struct Clear
+{
+    static constexpr Type type = Type::Clear;
+};
+
+struct SetMatrix
+{
+    static constexpr Type type = Type::SetMatrix;
+
+    Renderer::MatrixType matrix_type;
+    glm::mat4            matrix;
+};
+
+struct LoadIdentity
+{
+    static constexpr Type type = Type::LoadIdentity;
+
+    Renderer::MatrixType matrix_type;
+};
+
+struct Lighting
+{
+    static constexpr Type type = Type::Lighting;
+
+    bool enable;
+};
+
+struct BindLight
+{
+    static constexpr Type type = Type::BindLight;
+
+    uint32_t       light_num;
+    LightComponent light;
+};
+
+struct UnbindLight
+{
+    static constexpr Type type = Type::UnbindLight;
+
+    uint32_t light_num;
+};
+
+struct BindMaterial
+{
+    static constexpr Type type = Type::BindMaterial;
+
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+    glm::vec4 specular;
+    float     shininess;
+    uint32_t  base_tex_id;
+};
+
+// followed by num_meshes RenderModel::mesh draw ranges
+struct DrawModel
+{
+    static constexpr Type type = Type::DrawModel;
+
+    uint32_t vertexbuffer;
+    uint32_t elementbuffer;
+    uint32_t stream_offset;
+    uint32_t index_width;
+    uint32_t num_meshes;
+};
+
+// unit cube transform relative to the current modelview matrix
+struct DrawBBox
+{
+    static constexpr Type type = Type::DrawBBox;
+
+    glm::mat4 transform;
+};
+}   // namespace cmd
+
+// Linear buffer of draw packets for one frame. Recording doesn't touch GL,
+// Renderer::execute replays the packets on the GL thread once the frame is
+// recorded.
+class CommandBuffer
+{
+public:
+    class Reader
+    {
+    public:
+        explicit Reader(CommandBuffer const & cmds) : m_cmds(cmds) {}
+
+        bool atEnd() const { return m_pos >= m_cmds.m_data.size(); }
+        // must be followed by read() of the matching packet
+        cmd::Type nextType()
+        {
+            cmd::Type type;
+            readBytes(&type, sizeof(type));
+            return type;
+        }
+
+        template<typename Packet>
+        Packet read()
+        {
+            static_assert(std::is_trivially_copyable_v<Packet>, "packets are copied as raw bytes");
+
+            Packet packet;
+            readBytes(&packet, sizeof(Packet));
+            return packet;
+        }
+
+    private:
+        void readBytes(void * dst, size_t size)
+        {
+            std::memcpy(dst, m_cmds.m_data.data() + m_pos, size);
+            m_pos += size;
+        }
+
+        CommandBuffer const & m_cmds;
+        size_t                m_pos = 0;
+    };
+
+    void clear()
+    {
+        m_data.clear();
+        m_num_packets = 0;
+    }
+
+    template<typename Packet>
+    void push(Packet const & packet)
+    {
+        static_assert(std::is_trivially_copyable_v<Packet>, "packets are copied as raw bytes");
+
+        writeBytes(&Packet::type, sizeof(cmd::Type));
+        writeBytes(&packet, sizeof(Packet));
+        m_num_packets++;
+    }
+
+    // recording helpers
+    void clearBuffers() { push(cmd::Clear{}); }
+    void setMatrix(Renderer::MatrixType type, glm::mat4 const & matrix)
+    {
+        push(cmd::SetMatrix{type, matrix});
+    }
+    void loadIdentity(Renderer::MatrixType type) { push(cmd::LoadIdentity{type}); }
+    void lighting(bool enable) { push(cmd::Lighting{enable}); }
+    void bindLight(uint32_t light_num, LightComponent const & light)
+    {
+        push(cmd::BindLight{light_num, light});
+    }
+    void unbindLight(uint32_t light_num) { push(cmd::UnbindLight{light_num}); }
+    void bindMaterial(MaterialComponent const & mat);
+    void drawModel(RenderModel const & mdl, uint32_t lod);
+    void drawBBox(glm::mat4 const & transform) { push(cmd::DrawBBox{transform}); }
+
+    size_t   getSize() const { return m_data.size(); }
+    uint32_t getNumPackets() const { return m_num_packets; }
+
+private:
+    void writeBytes(void const * src, size_t size)
+    {
+        auto const * bytes = static_cast<uint8_t const *>(src);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    std::vector<uint8_t> m_data;
+    uint32_t             m_num_packets = 0;
+};
+
+#endif   // COMMANDBUFFER_H
@@ -0,0 +1,86 @@
+#include "framebuilder.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../scene/material.h"
+#include "../scene/model.h"
+#include "../scene/scenecmp.h"
+
+namespace
+{
+constexpr uint32_t max_lights = 8;
+}   // namespace
+
+void FrameBuilder::record(CameraComponent const & cam, std::vector<Entity> const & models,
+                          std::vector<Entity> const & lights, CommandBuffer & cmds)
+{
+    auto const num_lights = std::min(static_cast<uint32_t>(lights.size()), max_lights);
+
+    cmds.clear();
+    cmds.clearBuffers();
+    cmds.setMatrix(Renderer::MatrixType::PROJECTION, cam.m_proj_mat);
+
+    // set lights
+    if(num_lights > 0)
+        cmds.lighting(true);
+
+    for(uint32_t i = 0; i < num_lights; ++i)
+        cmds.bindLight(i, m_reg.get<LightComponent>(lights[i]));
+
+    // batches share buffers and material, the material is bound once per batch
+    m_queue.build(models, cam.m_view_mat);
+
+    auto const & instances = m_queue.getInstances();
+    for(auto const & batch : m_queue.getBatches())
+    {
+        auto const first = instances[batch.first];
+
+        if(m_reg.has<MaterialComponent>(first))
+            cmds.bindMaterial(m_reg.get<MaterialComponent>(first));
+
+        for(uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+        {
+            // not uploaded yet
+            if(!m_reg.has<RenderModel>(instances[i]))
+                continue;
+
+            auto const & node_pos = m_reg.get<WorldTransformComponent>(instances[i]);
+            auto const & gl_mdl   = m_reg.get<RenderModel>(instances[i]);
+            uint32_t     lod      = m_reg.get<ModelComponent>(instances[i]).lod;
+
+            // a skinned model has only the vertices of the lod it was skinned for
+            if(gl_mdl.m_streamed)
+                lod = std::max(lod, gl_mdl.m_skinned_lod);
+
+            cmds.setMatrix(Renderer::MatrixType::MODELVIEW, cam.m_view_mat * node_pos.abs.toMat4());
+            cmds.drawModel(gl_mdl, std::min(lod, gl_mdl.m_num_lods - 1));
+        }
+    }
+
+    if(num_lights > 0)
+        cmds.lighting(false);
+
+    for(uint32_t i = 0; i < num_lights; ++i)
+        cmds.unbindLight(i);
+
+    // debug bounds are unlit, a separate pass keeps lighting from toggling per node
+    for(auto node : instances)
+    {
+        auto const & node_bnd = m_reg.get<BoundsComponent>(node);
+        auto const & node_pos = m_reg.get<WorldTransformComponent>(node);
+
+        if(!node_bnd.transformed_bbox)
+            continue;
+
+        glm::vec3 size      = node_bnd.transformed_bbox->max() - node_bnd.transformed_bbox->min();
+        glm::vec3 center    = (node_bnd.transformed_bbox->min() + node_bnd.transformed_bbox->max()) / 2.0f;
+        glm::mat4 transform = node_pos.abs.inverse().toMat4() * glm::translate(glm::mat4(1), center)
+                              * glm::scale(glm::mat4(1), size);
+
+        cmds.setMatrix(Renderer::MatrixType::MODELVIEW, cam.m_view_mat * node_pos.abs.toMat4());
+        cmds.drawBBox(transform);
+    }
+
+    cmds.loadIdentity(Renderer::MatrixType::PROJECTION);
+    cmds.loadIdentity(Renderer::MatrixType::MODELVIEW);
+}
@@ -0,0 +1,28 @@
+#ifndef FRAMEBUILDER_H
+#define FRAMEBUILDER_H
+
+#include <vector>
+
+#include "commandbuffer.h"
+#include "renderqueue.h"
+#include "../scene/camera.h"
+
+// Renderer front-end: turns the visible sets of the scene into draw packets.
+// It only reads the registry and makes no GL calls, the frame is recorded on
+// the GL thread right before Renderer::execute replays it.
+class FrameBuilder
+{
+public:
+    FrameBuilder(Registry & reg) : m_reg(reg), m_queue(reg) {}
+
+    void record(CameraComponent const & cam, std::vector<Entity> const & models,
+                std::vector<Entity> const & lights, CommandBuffer & cmds);
+
+    RenderQueue const & getQueue() const { return m_queue; }
+
+private:
+    Registry &  m_reg;
+    RenderQueue m_queue;
+};
+
+#endif   // FRAMEBUILDER_H
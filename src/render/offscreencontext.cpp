@@ -0,0 +1,177 @@
+#include "offscreencontext.h"
+#include <GL/glew.h>
+#include <cstring>
+
+#ifndef _WIN32
+#    include <EGL/egl.h>
+#    include <EGL/eglext.h>
+#endif
+
+OffscreenContext::~OffscreenContext()
+{
+    destroy();
+}
+
+#ifdef _WIN32
+// no EGL on windows, offscreen runs are linux only
+bool OffscreenContext::create()
+{
+    m_error = "EGL is not available on windows";
+    return false;
+}
+
+void OffscreenContext::destroy() {}
+#else
+namespace
+{
+bool HasExtension(char const * extensions, char const * name)
+{
+    return extensions != nullptr && std::strstr(extensions, name) != nullptr;
+}
+
+EGLDisplay GetDisplay()
+{
+    // prefer a display that needs neither X11 nor a DRM device
+    auto const get_platform_display =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if(get_platform_display != nullptr
+       && HasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless"))
+    {
+        EGLDisplay display =
+            get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if(display != EGL_NO_DISPLAY)
+            return display;
+    }
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+}   // namespace
+
+bool OffscreenContext::create()
+{
+    EGLDisplay display = GetDisplay();
+    if(display == EGL_NO_DISPLAY || eglInitialize(display, nullptr, nullptr) == EGL_FALSE)
+        return fail("no EGL display");
+
+    m_display = display;
+
+    char const * const extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if(!HasExtension(extensions, "EGL_KHR_surfaceless_context"))
+        return fail("EGL_KHR_surfaceless_context is not supported");
+    if(eglBindAPI(EGL_OPENGL_API) == EGL_FALSE)
+        return fail("desktop OpenGL is not supported by EGL");
+
+    EGLint const config_attribs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                     EGL_NONE};
+    EGLConfig    config           = EGL_NO_CONFIG_KHR;
+    EGLint       num_configs      = 0;
+
+    // the surfaceless platform may have no configs at all, a context without
+    // one needs EGL_KHR_no_config_context
+    if(eglChooseConfig(display, config_attribs, &config, 1, &num_configs) == EGL_FALSE || num_configs == 0)
+    {
+        if(!HasExtension(extensions, "EGL_KHR_no_config_context"))
+            return fail("no EGL config for OpenGL and EGL_KHR_no_config_context is not supported");
+
+        config = EGL_NO_CONFIG_KHR;
+    }
+
+    // default attributes give a compatibility profile, the renderer is fixed function
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+    if(context == EGL_NO_CONTEXT)
+        return fail("eglCreateContext failed");
+
+    m_context = context;
+
+    if(eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_FALSE)
+        return fail("eglMakeCurrent failed");
+
+    return true;
+}
+
+bool OffscreenContext::fail(char const * error)
+{
+    destroy();
+    m_error = error;
+    return false;
+}
+
+void OffscreenContext::destroy()
+{
+    if(m_context != nullptr)
+    {
+        if(m_framebuffer != 0)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &m_framebuffer);
+            glDeleteRenderbuffers(1, &m_color_buffer);
+            glDeleteRenderbuffers(1, &m_depth_buffer);
+
+            m_framebuffer = m_color_buffer = m_depth_buffer = 0;
+        }
+
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_display, m_context);
+        m_context = nullptr;
+    }
+
+    if(m_display != nullptr)
+    {
+        eglTerminate(m_display);
+        m_display = nullptr;
+    }
+}
+#endif
+
+bool OffscreenContext::initFramebuffer(int32_t width, int32_t height)
+{
+    if(GLEW_ARB_framebuffer_object != GL_TRUE && GLEW_VERSION_3_0 != GL_TRUE)
+        return false;
+
+    m_width  = width;
+    m_height = height;
+
+    glGenRenderbuffers(1, &m_color_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depth_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // stays bound, nothing else in the renderer touches the framebuffer binding
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color_buffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth_buffer);
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void OffscreenContext::finish() const
+{
+    glFinish();
+}
+
+bool OffscreenContext::readPixels(tex::ImageData & image) const
+{
+    if(m_framebuffer == 0)
+        return false;
+
+    auto const width  = static_cast<uint32_t>(m_width);
+    auto const height = static_cast<uint32_t>(m_height);
+
+    image.width  = width;
+    image.height = height;
+    image.type   = tex::ImageData::PixelType::pt_rgba;
+    image.data   = std::make_unique<uint8_t[]>(width * height * 4);
+
+    // rows start at the lower-left corner like ImageData
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, image.data.get());
+
+    return true;
+}
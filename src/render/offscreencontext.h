@@ -0,0 +1,46 @@
+#ifndef OFFSCREENCONTEXT_H
+#define OFFSCREENCONTEXT_H
+
+#include <cstdint>
+
+#include "../res/imagedata.h"
+
+// GL context without a display: EGL surfaceless (Mesa llvmpipe works) with
+// the frame rendered into a framebuffer object
+class OffscreenContext
+{
+public:
+    OffscreenContext() = default;
+    ~OffscreenContext();
+
+    OffscreenContext(OffscreenContext const &)             = delete;
+    OffscreenContext & operator=(OffscreenContext const &) = delete;
+
+    // makes the context current, call initFramebuffer after the GL entry points are loaded
+    bool create();
+    bool initFramebuffer(int32_t width, int32_t height);
+    void destroy();
+    bool isCreated() const { return m_context != nullptr; }
+
+    // why create failed
+    char const * getError() const { return m_error; }
+
+    // blocks until the frame is rendered
+    void finish() const;
+    bool readPixels(tex::ImageData & image) const;
+
+private:
+    bool fail(char const * error);
+
+    void *       m_display = nullptr;   // EGLDisplay
+    void *       m_context = nullptr;   // EGLContext
+    char const * m_error   = "";
+
+    uint32_t m_framebuffer  = 0;
+    uint32_t m_color_buffer = 0;
+    uint32_t m_depth_buffer = 0;
+    int32_t  m_width        = 0;
+    int32_t  m_height       = 0;
+};
+
+#endif   // OFFSCREENCONTEXT_H
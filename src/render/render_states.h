@@ -155,4 +155,24 @@ struct WireState
     bool operator==(WireState const & other) { return (enabled == other.enabled); }
 };
 
+struct ClientState
+{
+    bool vertex_array    = false;
+    bool normal_array    = false;
+    bool tex_coord_array = false;
+
+    bool operator==(ClientState const & other)
+    {
+        return (vertex_array == other.vertex_array) && (normal_array == other.normal_array)
+               && (tex_coord_array == other.tex_coord_array);
+    }
+};
+
+// GL calls made by the shadowed state changes and the redundant ones skipped
+struct StateStats
+{
+    uint32_t issued = 0;
+    uint32_t elided = 0;
+};
+
 #endif
@@ -0,0 +1,22 @@
+#include "renderbackend.h"
+#include "backendgl.h"
+#include "backendnull.h"
+
+#include <ostream>
+#include <stdexcept>
+
+std::unique_ptr<RenderBackend> CreateRenderBackend(RenderBackend::Type type, std::ostream * log)
+{
+    switch(type)
+    {
+        case RenderBackend::Type::Null:
+            return std::make_unique<NullBackend>();
+        case RenderBackend::Type::Recording:
+            if(log == nullptr || !*log)
+                throw std::runtime_error{"The record backend needs an open log"};
+            return std::make_unique<RecordingBackend>(*log);
+        case RenderBackend::Type::GL:
+        default:
+            return std::make_unique<GLBackend>();
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+
+// counters of the work submitted to a backend
+struct BackendStats
+{
+    uint64_t calls         = 0;
+    uint64_t draw_calls    = 0;
+    uint64_t indices       = 0;
+    uint64_t buffer_bytes  = 0;   // glBufferData/glBufferSubData uploads
+    uint64_t texture_bytes = 0;
+    uint64_t mapped_bytes  = 0;
+    uint64_t frames        = 0;
+};
+
+// The subset of OpenGL 1.5 (+ ARB_map_buffer_range, ARB_sync) used by the
+// renderer. Arguments are the GL ones, enums keep their GL values.
+class RenderBackend
+{
+public:
+    enum class Type
+    {
+        GL,
+        Null,        // counts calls and bytes, no output
+        Recording    // null backend that logs the call stream
+    };
+
+    RenderBackend()          = default;
+    virtual ~RenderBackend() = default;
+
+    RenderBackend(RenderBackend const &)             = delete;
+    RenderBackend & operator=(RenderBackend const &) = delete;
+
+    // the GL backend needs a current context, the others run headless
+    virtual bool needsContext() const      = 0;
+    virtual bool hasMapBufferRange() const = 0;
+    virtual bool hasSync() const           = 0;
+
+    // end of the frame, before the swap
+    virtual void endFrame() {}
+
+    // state
+    virtual void enable(uint32_t cap)                                          = 0;
+    virtual void disable(uint32_t cap)                                         = 0;
+    virtual void enableClientState(uint32_t array)                             = 0;
+    virtual void disableClientState(uint32_t array)                            = 0;
+    virtual void hint(uint32_t target, uint32_t mode)                          = 0;
+    virtual void shadeModel(uint32_t mode)                                     = 0;
+    virtual void viewport(int32_t x, int32_t y, int32_t width, int32_t height) = 0;
+    virtual void polygonOffset(float factor, float units)                      = 0;
+    virtual void polygonMode(uint32_t face, uint32_t mode)                     = 0;
+    virtual void lineWidth(float width)                                        = 0;
+    virtual void blendFunc(uint32_t src, uint32_t dst)                         = 0;
+    virtual void blendColor(float r, float g, float b, float a)                = 0;
+    virtual void alphaFunc(uint32_t func, float ref)                           = 0;
+    virtual void frontFace(uint32_t mode)                                      = 0;
+    virtual void cullFace(uint32_t mode)                                       = 0;
+    virtual void depthFunc(uint32_t func)                                      = 0;
+    virtual void depthMask(bool flag)                                          = 0;
+    virtual void stencilFunc(uint32_t func, int32_t ref, uint32_t mask)        = 0;
+    virtual void stencilMask(uint32_t mask)                                    = 0;
+    virtual void stencilOp(uint32_t fail, uint32_t z_fail, uint32_t z_pass)    = 0;
+
+    // clear
+    virtual void clearColor(float r, float g, float b, float a) = 0;
+    virtual void clearDepth(double depth)                       = 0;
+    virtual void clearStencil(int32_t s)                        = 0;
+    virtual void clear(uint32_t mask)                           = 0;
+
+    // fixed function transform and lighting
+    virtual void matrixMode(uint32_t mode)                                       = 0;
+    virtual void loadMatrix(float const * m)                                     = 0;
+    virtual void loadIdentity()                                                  = 0;
+    virtual void multMatrix(float const * m)                                     = 0;
+    virtual void pushMatrix()                                                    = 0;
+    virtual void popMatrix()                                                     = 0;
+    virtual void color3f(float r, float g, float b)                              = 0;
+    virtual void materialfv(uint32_t face, uint32_t pname, float const * params) = 0;
+    virtual void materialf(uint32_t face, uint32_t pname, float param)           = 0;
+    virtual void lightfv(uint32_t light, uint32_t pname, float const * params)   = 0;
+    virtual void lightf(uint32_t light, uint32_t pname, float param)             = 0;
+
+    // buffers, offsets into a bound buffer are passed as pointers like in GL
+    virtual void   genBuffers(int32_t n, uint32_t * buffers)                                      = 0;
+    virtual void   deleteBuffers(int32_t n, uint32_t const * buffers)                             = 0;
+    virtual void   bindBuffer(uint32_t target, uint32_t buffer)                                   = 0;
+    virtual void   bufferData(uint32_t target, size_t size, void const * data, uint32_t usage)    = 0;
+    virtual void   bufferSubData(uint32_t target, size_t offset, size_t size, void const * data)  = 0;
+    virtual void * mapBuffer(uint32_t target, uint32_t access)                                    = 0;
+    virtual void * mapBufferRange(uint32_t target, size_t offset, size_t length, uint32_t access) = 0;
+    virtual bool   unmapBuffer(uint32_t target)                                                   = 0;
+
+    // textures
+    virtual void genTextures(int32_t n, uint32_t * textures)                   = 0;
+    virtual void deleteTextures(int32_t n, uint32_t const * textures)          = 0;
+    virtual void bindTexture(uint32_t target, uint32_t texture)                = 0;
+    virtual void texParameteri(uint32_t target, uint32_t pname, int32_t param) = 0;
+    virtual void texImage2D(uint32_t target, int32_t level, int32_t internal_format, int32_t width,
+                            int32_t height, int32_t border, uint32_t format, uint32_t type,
+                            void const * pixels) = 0;
+
+    // vertex arrays and drawing
+    virtual void vertexPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr)    = 0;
+    virtual void normalPointer(uint32_t type, int32_t stride, void const * ptr)                  = 0;
+    virtual void texCoordPointer(int32_t size, uint32_t type, int32_t stride, void const * ptr)  = 0;
+    virtual void drawElements(uint32_t mode, int32_t count, uint32_t type, void const * indices) = 0;
+
+    // fences, a handle is a GLsync
+    virtual void * fenceSync()                   = 0;
+    virtual void   clientWaitSync(void * handle) = 0;
+    virtual void   deleteSync(void * handle)     = 0;
+
+    // counters are kept by the headless backends, the GL one leaves them zero
+    BackendStats const & getStats() const { return m_stats; }
+    void                 resetStats() { m_stats = BackendStats(); }
+
+protected:
+    BackendStats m_stats;
+};
+
+// log is used by the recording backend only, which throws if it is missing or not open
+std::unique_ptr<RenderBackend> CreateRenderBackend(RenderBackend::Type type, std::ostream * log = nullptr);
+
+#endif   // RENDERBACKEND_H
@@ -1,10 +1,15 @@
 #include "renderer.h"
+#include "commandbuffer.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <GL/glew.h>
+#include <algorithm>
+#include <cstddef>
 
 #include "../scene/material.h"
 #include "../scene/light.h"
 #include "../scene/model.h"
+#include "../utils/allocstats.h"
+#include "../utils/framearena.h"
 
 // Mappings
 GLenum g_gl_compare_mode[static_cast<uint32_t>(CompareMode::QUANTITY)] = {
@@ -58,37 +63,88 @@ GLenum g_gl_stencil_operation[static_cast<uint32_t>(StencilState::OperationType:
     GL_INVERT     // INVERT
 };
 
+namespace
+{
+void PackVertices(std::vector<Mesh> const & meshes, std::vector<RenderModel::vertex> & vertices)
+{
+    vertices.clear();
+
+    for(auto const & msh : meshes)
+    {
+        for(uint32_t i = 0; i < msh.pos.size(); ++i)
+        {
+            vertices.push_back(
+                {msh.pos[i], msh.normal[i], msh.tex_coords[i], msh.tangent[i], msh.bitangent[i]});
+        }
+    }
+}
+
+// textures built in (default material) are never shared
+std::string SharedTextureKey(MaterialComponent const & mat)
+{
+    if(mat.m_diff_fname.empty())
+        return {};
+
+    return mat.m_diff_fname + '|' + mat.m_bump_fname;
+}
+
+// GL calls made by the commit of a global state
+uint32_t CountCalls(AlphaState const & state)
+{
+    return (state.blend_enabled ? 3 : 1) + (state.compare_enabled ? 2 : 1);
+}
+
+uint32_t CountCalls(CullState const & state)
+{
+    return state.enabled ? 3 : 1;
+}
+
+uint32_t CountCalls(DepthState const & state)
+{
+    return (state.enabled ? 2 : 1) + 1;
+}
+
+uint32_t CountCalls(OffsetState const &)
+{
+    return 4;
+}
+
+uint32_t CountCalls(StencilState const & state)
+{
+    return state.enabled ? 4 : 1;
+}
+
+uint32_t CountCalls(WireState const &)
+{
+    return 1;
+}
+}   // namespace
+
 void Renderer::update(double time)
 {
     for(auto ent : m_reg.view<ModelComponent, Event::Model::UploadBuffer>())
     {
         uploadModel(ent);
+
+        // skinned models stream from the CPU copy every frame
+        if(m_residency == Residency::ReleaseStatic && !m_reg.get<RenderModel>(ent).m_streamed)
+            ModelSystem::ReleaseMeshData(m_reg.get<ModelComponent>(ent));
     }
     m_reg.reset<Event::Model::UploadBuffer>();
 
     for(auto ent : m_reg.view<ModelComponent, Event::Model::UploadTexture>())
     {
         uploadMaterialData(ent);
+
+        if(m_residency == Residency::ReleaseStatic)
+            MaterialSystem::ReleaseImages(m_reg.get<MaterialComponent>(ent));
     }
     m_reg.reset<Event::Model::UploadTexture>();
 
+    // skinned lazily, only if the model is in the queue of a later frame
     for(auto ent : m_reg.view<ModelComponent, RenderModel, Event::Model::VertexDataChanged>())
     {
-        auto const & geom   = m_reg.get<ModelComponent>(ent);
-        auto const & gl_mdl = m_reg.get<RenderModel>(ent);
-
-        for(uint32_t i = 0; i < geom.meshes.size(); ++i)
-        {
-            auto const & msh = geom.meshes[i];
-
-            glBindBuffer(GL_ARRAY_BUFFER_ARB, gl_mdl.model[i].m_vertexbuffer);
-            glBufferSubData(GL_ARRAY_BUFFER_ARB, 0, msh.frame_pos.size() * 3 * sizeof(float),
-                            &msh.frame_pos[0]);
-
-            glBindBuffer(GL_ARRAY_BUFFER_ARB, gl_mdl.model[i].m_normalbuffer);
-            glBufferSubData(GL_ARRAY_BUFFER_ARB, 0, msh.frame_normal.size() * 3 * sizeof(float),
-                            &msh.frame_normal[0]);
-        }
+        m_reg.get<RenderModel>(ent).m_skin_dirty = true;
     }
 
     for(auto ent : m_reg.view<ModelComponent, RenderModel, Event::Model::UnloadBuffer>())
@@ -106,13 +162,17 @@ void Renderer::update(double time)
 
 bool Renderer::init()
 {
+    // a new context starts with the GL defaults, a shared one doesn't share them
+    resetStateShadow();
     commitAllStates();
     clearBuffers();
 
-    glShadeModel(GL_SMOOTH);
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
-    glEnable(GL_NORMALIZE);
-    glEnable(GL_TEXTURE_2D);
+    m_backend->shadeModel(GL_SMOOTH);
+    m_backend->hint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
+    m_backend->enable(GL_NORMALIZE);
+    m_backend->enable(GL_TEXTURE_2D);
+
+    m_map_buffer_range = m_backend->hasMapBufferRange();
 
     // bbox
     float vertices[] = {
@@ -123,19 +183,14 @@ bool Renderer::init()
 
     unsigned short elements[] = {0, 1, 2, 3, 4, 5, 6, 7, 0, 4, 1, 5, 2, 6, 3, 7};
 
-    glGenBuffers(1, &m_bbox_vbo_vertices);
-    glGenBuffers(1, &m_bbox_ibo_elements);
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_bbox_vbo_vertices);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_backend->genBuffers(1, &m_bbox_vbo_vertices);
+    m_backend->genBuffers(1, &m_bbox_ibo_elements);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_bbox_ibo_elements);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(elements), elements, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    bindArrayBuffer(m_bbox_vbo_vertices);
+    m_backend->bufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    bindElementBuffer(m_bbox_ibo_elements);
+    m_backend->bufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(elements), elements, GL_STATIC_DRAW);
 
     return true;
 }
@@ -144,72 +199,161 @@ void Renderer::terminate()
 {
     if(!m_terminated)
     {
-        glDeleteBuffers(1, &m_bbox_vbo_vertices);
-        glDeleteBuffers(1, &m_bbox_ibo_elements);
+        m_backend->deleteBuffers(1, &m_bbox_vbo_vertices);
+        m_backend->deleteBuffers(1, &m_bbox_ibo_elements);
+        forgetBuffer(m_bbox_vbo_vertices);
+        forgetBuffer(m_bbox_ibo_elements);
 
         m_bbox_vbo_vertices = m_bbox_ibo_elements = 0;
 
+        for(auto & fence : m_region_fences)
+        {
+            if(fence != nullptr)
+                m_backend->deleteSync(fence);
+
+            fence = nullptr;
+        }
+
         for(auto ent : m_reg.view<ModelComponent, RenderModel, MaterialComponent>())
         {
             unloadMaterialData(ent);
             unloadModel(ent);
         }
 
+        for(auto arena : {&m_vertex_arena, &m_index_arena})
+        {
+            for(auto buffer : arena->clear())
+            {
+                m_backend->deleteBuffers(1, &buffer);
+                forgetBuffer(buffer);
+            }
+        }
+
         m_terminated = true;
     }
 }
 
-void Renderer::setMatrix(MatrixType type, glm::mat4 const & matrix) const
+void Renderer::contextLost()
 {
-    GLenum const matrix_type = (type == MatrixType::PROJECTION) ? GL_PROJECTION : GL_MODELVIEW;
+    for(auto ent : m_reg.view<ModelComponent>())
+    {
+        if(m_reg.has<RenderModel>(ent))
+            m_reg.get<RenderModel>(ent) = RenderModel();
 
-    glMatrixMode(matrix_type);
-    glLoadMatrixf(glm::value_ptr(matrix));
+        if(m_reg.has<MaterialComponent>(ent))
+        {
+            auto & mat        = m_reg.get<MaterialComponent>(ent);
+            mat.m_base_tex_id = 0;
+            mat.m_bump_tex_id = 0;
+        }
+
+        m_reg.add_component<Event::Model::ReloadData>(ent);
+    }
+
+    m_shared_meshes.clear();
+    m_shared_textures.clear();
+    m_texture_bytes.clear();
+    m_vertex_arena.clear();
+    m_index_arena.clear();
+    m_region_fences.fill(nullptr);
+
+    m_bbox_vbo_vertices = 0;
+    m_bbox_ibo_elements = 0;
 }
 
-void Renderer::loadIdentityMatrix(MatrixType type) const
+void Renderer::resetStateShadow() const
 {
-    GLenum const matrix_type = (type == MatrixType::PROJECTION) ? GL_PROJECTION : GL_MODELVIEW;
+    m_client         = ClientState();
+    m_array_buffer   = 0;
+    m_element_buffer = 0;
+    m_arrays_source  = 0;
+    m_arrays_offset  = 0;
+    m_texture        = 0;
+    m_lighting       = false;
+    m_matrix_mode    = MatrixType::MODELVIEW;
+    m_material_bound = false;
+}
 
-    glMatrixMode(matrix_type);
-    glLoadIdentity();
+void Renderer::setMatrix(MatrixType type, glm::mat4 const & matrix) const
+{
+    setMatrixMode(type);
+    m_backend->loadMatrix(glm::value_ptr(matrix));
+}
+
+void Renderer::loadIdentityMatrix(MatrixType type) const
+{
+    setMatrixMode(type);
+    m_backend->loadIdentity();
 }
 
 void Renderer::uploadMaterialData(Entity entity_id) const
 {
-    auto & mat = m_reg.get<MaterialComponent>(entity_id);
+    auto &            mat        = m_reg.get<MaterialComponent>(entity_id);
+    std::string const shared_key = SharedTextureKey(mat);
 
-    glGenTextures(1, &mat.m_base_tex_id);
-    glBindTexture(GL_TEXTURE_2D, mat.m_base_tex_id);
-    glTexImage2D(GL_TEXTURE_2D, 0, mat.m_diff.type == tex::ImageData::PixelType::pt_rgb ? 3 : 4,
-                 static_cast<GLsizei>(mat.m_diff.width), static_cast<GLsizei>(mat.m_diff.height), 0,
-                 mat.m_diff.type == tex::ImageData::PixelType::pt_rgb ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE,
-                 mat.m_diff.data.get());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if(!shared_key.empty())
+    {
+        auto it = m_shared_textures.find(shared_key);
+        if(it != m_shared_textures.end())
+        {
+            mat.m_base_tex_id = it->second.base_tex_id;
+            mat.m_bump_tex_id = it->second.bump_tex_id;
+            it->second.ref_count++;
 
-    glGenTextures(1, &mat.m_bump_tex_id);
-    glBindTexture(GL_TEXTURE_2D, mat.m_bump_tex_id);
-    glTexImage2D(GL_TEXTURE_2D, 0, mat.m_bump.type == tex::ImageData::PixelType::pt_rgb ? 3 : 4,
-                 static_cast<GLsizei>(mat.m_bump.width), static_cast<GLsizei>(mat.m_bump.height), 0,
-                 mat.m_bump.type == tex::ImageData::PixelType::pt_rgb ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE,
-                 mat.m_bump.data.get());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            return;
+        }
+    }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    m_backend->genTextures(1, &mat.m_base_tex_id);
+    bindTexture(mat.m_base_tex_id);
+    m_backend->texImage2D(GL_TEXTURE_2D, 0, mat.m_diff.type == tex::ImageData::PixelType::pt_rgb ? 3 : 4,
+                          static_cast<GLsizei>(mat.m_diff.width), static_cast<GLsizei>(mat.m_diff.height), 0,
+                          mat.m_diff.type == tex::ImageData::PixelType::pt_rgb ? GL_RGB : GL_RGBA,
+                          GL_UNSIGNED_BYTE, mat.m_diff.data.get());
+    m_backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    m_backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    m_backend->genTextures(1, &mat.m_bump_tex_id);
+    bindTexture(mat.m_bump_tex_id);
+    m_backend->texImage2D(GL_TEXTURE_2D, 0, mat.m_bump.type == tex::ImageData::PixelType::pt_rgb ? 3 : 4,
+                          static_cast<GLsizei>(mat.m_bump.width), static_cast<GLsizei>(mat.m_bump.height), 0,
+                          mat.m_bump.type == tex::ImageData::PixelType::pt_rgb ? GL_RGB : GL_RGBA,
+                          GL_UNSIGNED_BYTE, mat.m_bump.data.get());
+    m_backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    m_backend->texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    bindTexture(0);
+
+    m_texture_bytes[mat.m_base_tex_id] = tex::GetImageBytes(mat.m_diff);
+    m_texture_bytes[mat.m_bump_tex_id] = tex::GetImageBytes(mat.m_bump);
+
+    if(!shared_key.empty())
+        m_shared_textures[shared_key] = {mat.m_base_tex_id, mat.m_bump_tex_id, 1};
 }
 
-void Renderer::bindMaterial(Entity entity_id) const
+void Renderer::bindMaterial(cmd::BindMaterial const & mat) const
 {
-    auto const & mat = m_reg.get<MaterialComponent>(entity_id);
-
-    glMaterialfv(GL_FRONT, GL_AMBIENT, glm::value_ptr(mat.m_ambient));
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, glm::value_ptr(mat.m_diffuse));
-    glMaterialfv(GL_FRONT, GL_SPECULAR, glm::value_ptr(mat.m_specular));
-    glMaterialf(GL_FRONT, GL_SHININESS, mat.m_shininess);
+    if(!m_material_bound || m_bound_ambient != mat.ambient || m_bound_diffuse != mat.diffuse
+       || m_bound_specular != mat.specular || m_bound_shininess != mat.shininess)
+    {
+        m_backend->materialfv(GL_FRONT, GL_AMBIENT, glm::value_ptr(mat.ambient));
+        m_backend->materialfv(GL_FRONT, GL_DIFFUSE, glm::value_ptr(mat.diffuse));
+        m_backend->materialfv(GL_FRONT, GL_SPECULAR, glm::value_ptr(mat.specular));
+        m_backend->materialf(GL_FRONT, GL_SHININESS, mat.shininess);
+
+        m_bound_ambient   = mat.ambient;
+        m_bound_diffuse   = mat.diffuse;
+        m_bound_specular  = mat.specular;
+        m_bound_shininess = mat.shininess;
+        m_material_bound  = true;
+        m_stats.issued += 4;
+    }
+    else
+    {
+        m_stats.elided += 4;
+    }
 
-    glBindTexture(GL_TEXTURE_2D, mat.m_base_tex_id);
+    bindTexture(mat.base_tex_id);
 }
 
 void Renderer::unloadMaterialData(Entity entity_id) const
@@ -219,8 +363,32 @@ void Renderer::unloadMaterialData(Entity entity_id) const
 
     auto & mat = m_reg.get<MaterialComponent>(entity_id);
 
-    glDeleteTextures(1, &mat.m_base_tex_id);
-    glDeleteTextures(1, &mat.m_bump_tex_id);
+    if(!mat.m_diff_fname.empty() && mat.m_base_tex_id != 0)
+    {
+        auto it = m_shared_textures.find(SharedTextureKey(mat));
+        if(it != m_shared_textures.end())
+        {
+            if(--it->second.ref_count > 0)
+            {
+                mat.m_base_tex_id = 0;
+                mat.m_bump_tex_id = 0;
+
+                return;
+            }
+
+            m_shared_textures.erase(it);
+        }
+    }
+
+    // deleting the bound texture reverts the binding to zero
+    if(m_texture == mat.m_base_tex_id || m_texture == mat.m_bump_tex_id)
+        m_texture = 0;
+
+    m_texture_bytes.erase(mat.m_base_tex_id);
+    m_texture_bytes.erase(mat.m_bump_tex_id);
+
+    m_backend->deleteTextures(1, &mat.m_base_tex_id);
+    m_backend->deleteTextures(1, &mat.m_bump_tex_id);
 
     mat.m_base_tex_id = 0;
     mat.m_bump_tex_id = 0;
@@ -228,114 +396,225 @@ void Renderer::unloadMaterialData(Entity entity_id) const
 
 void Renderer::lighting(bool enable) const
 {
+    if(m_lighting == enable)
+    {
+        m_stats.elided++;
+        return;
+    }
+
+    m_lighting = enable;
+    m_stats.issued++;
+
     if(enable)
-        glEnable(GL_LIGHTING);
+        m_backend->enable(GL_LIGHTING);
     else
-        glDisable(GL_LIGHTING);
+        m_backend->disable(GL_LIGHTING);
 }
 
-void Renderer::bindLight(Entity entity_id, uint32_t light_num) const
+void Renderer::bindLight(LightComponent const & lgh, uint32_t light_num) const
 {
     assert(light_num < 8);
 
-    auto const & lgh           = m_reg.get<LightComponent>(entity_id);
     GLenum const light_src_num = GL_LIGHT0 + light_num;
 
-    glLightfv(light_src_num, GL_POSITION, glm::value_ptr(lgh.position));
-    glLightfv(light_src_num, GL_AMBIENT, glm::value_ptr(lgh.ambient));
-    glLightfv(light_src_num, GL_DIFFUSE, glm::value_ptr(lgh.diffuse));
-    glLightfv(light_src_num, GL_SPECULAR, glm::value_ptr(lgh.specular));
+    m_backend->lightfv(light_src_num, GL_POSITION, glm::value_ptr(lgh.position));
+    m_backend->lightfv(light_src_num, GL_AMBIENT, glm::value_ptr(lgh.ambient));
+    m_backend->lightfv(light_src_num, GL_DIFFUSE, glm::value_ptr(lgh.diffuse));
+    m_backend->lightfv(light_src_num, GL_SPECULAR, glm::value_ptr(lgh.specular));
 
     if(lgh.type == LightType::Point || lgh.type == LightType::Spot)
     {
-        glLightf(light_src_num, GL_CONSTANT_ATTENUATION, lgh.attenuation.x);
-        glLightf(light_src_num, GL_LINEAR_ATTENUATION, lgh.attenuation.y);
-        glLightf(light_src_num, GL_QUADRATIC_ATTENUATION, lgh.attenuation.z);
+        m_backend->lightf(light_src_num, GL_CONSTANT_ATTENUATION, lgh.attenuation.x);
+        m_backend->lightf(light_src_num, GL_LINEAR_ATTENUATION, lgh.attenuation.y);
+        m_backend->lightf(light_src_num, GL_QUADRATIC_ATTENUATION, lgh.attenuation.z);
     }
     if(lgh.type == LightType::Spot)
     {
         float angle = glm::degrees(glm::acos(lgh.spot_cos_cutoff));
 
-        glLightf(light_src_num, GL_SPOT_CUTOFF, angle);
-        glLightfv(light_src_num, GL_SPOT_DIRECTION, glm::value_ptr(lgh.spot_direction));
-        glLightf(light_src_num, GL_SPOT_EXPONENT, lgh.spot_exponent);
+        m_backend->lightf(light_src_num, GL_SPOT_CUTOFF, angle);
+        m_backend->lightfv(light_src_num, GL_SPOT_DIRECTION, glm::value_ptr(lgh.spot_direction));
+        m_backend->lightf(light_src_num, GL_SPOT_EXPONENT, lgh.spot_exponent);
     }
     // Enable light source
-    glEnable(light_src_num);
+    m_backend->enable(light_src_num);
 }
 
 void Renderer::unbindLight(uint32_t light_num) const
 {
     assert(light_num < 8);
-    glDisable(GL_LIGHT0 + light_num);
+    m_backend->disable(GL_LIGHT0 + light_num);
 }
 
 void Renderer::uploadModel(Entity entity_id) const
 {
-    auto const & mdl = m_reg.get<ModelComponent>(entity_id);
+    MemTagScope  tag(MemTag::Render);
+    auto const & mdl      = m_reg.get<ModelComponent>(entity_id);
+    bool const   streamed = m_reg.has<CurrentAnimSequence>(entity_id);
     RenderModel  gl_mdl;
 
-    // Generate buffers
-    for(auto const & msh : mdl.meshes)
+    if(!streamed && !mdl.mesh_name.empty())
+    {
+        auto it = m_shared_meshes.find(mdl.mesh_name);
+        if(it != m_shared_meshes.end())
+        {
+            it->second.ref_count++;
+            m_reg.add_component<RenderModel>(entity_id, it->second.model);
+
+            return;
+        }
+    }
+
+    std::vector<RenderModel::vertex> vertices;
+    std::vector<uint32_t>            indices;
+
+    PackVertices(mdl.meshes, vertices);
+
+    auto const num_meshes = static_cast<uint32_t>(mdl.meshes.size());
+
+    for(uint32_t lod = 0; lod < mdl.num_lods; ++lod)
+    {
+        uint32_t first_vertex = 0;
+        for(uint32_t m = 0; m < num_meshes; ++m)
+        {
+            auto const & msh = mdl.meshes[m];
+
+            // meshes with fewer levels draw the range of their coarsest one
+            if(lod > msh.lods.size())
+            {
+                gl_mdl.model.push_back(gl_mdl.model[(lod - 1) * num_meshes + m]);
+                first_vertex += static_cast<uint32_t>(msh.pos.size());
+                continue;
+            }
+
+            auto const &      msh_indexes = lod == 0 ? msh.indexes : msh.lods[lod - 1].indexes;
+            RenderModel::mesh cur_msh;
+
+            cur_msh.m_first_index  = static_cast<uint32_t>(indices.size());
+            cur_msh.m_indices_size = static_cast<GLsizei>(msh_indexes.size());
+
+            for(auto const index : msh_indexes)
+                indices.push_back(index + first_vertex);
+
+            first_vertex += static_cast<uint32_t>(msh.pos.size());
+            gl_mdl.model.push_back(cur_msh);
+        }
+
+        gl_mdl.m_num_vertices = first_vertex;
+    }
+
+    gl_mdl.m_num_lods     = mdl.num_lods;
+    gl_mdl.m_streamed     = streamed;
+    gl_mdl.m_region_size  = static_cast<uint32_t>(vertices.size() * sizeof(RenderModel::vertex));
+
+    uint32_t base_vertex = 0;
+    if(!gl_mdl.m_streamed)
+    {
+        auto const range =
+            arenaUpload(m_vertex_arena, GL_ARRAY_BUFFER, gl_mdl.m_region_size, vertices.data());
+
+        gl_mdl.m_vertexbuffer  = range.buffer;
+        gl_mdl.m_vertex_offset = range.offset;
+
+        // the vertex pointers are set to the start of the page
+        base_vertex = static_cast<uint32_t>(range.offset / sizeof(RenderModel::vertex));
+        for(auto & index : indices)
+            index += base_vertex;
+    }
+    else
     {
-        RenderModel::mesh cur_msh;
+        // skinned models own a buffer, it's orphaned or split into regions
+        m_backend->genBuffers(1, &gl_mdl.m_vertexbuffer);
+        bindArrayBuffer(gl_mdl.m_vertexbuffer);
+    }
 
-        glGenBuffers(1, &cur_msh.m_vertexbuffer);
-        glBindBuffer(GL_ARRAY_BUFFER, cur_msh.m_vertexbuffer);
-        glBufferData(GL_ARRAY_BUFFER, msh.pos.size() * 3 * sizeof(float), msh.pos.data(), GL_DYNAMIC_DRAW);
+    if(gl_mdl.m_streamed && m_map_buffer_range)
+    {
+        // bind pose in the region of the current frame until the first skinned frame
+        gl_mdl.m_stream_offset = m_stream_region * gl_mdl.m_region_size;
 
-        glGenBuffers(1, &cur_msh.m_normalbuffer);
-        glBindBuffer(GL_ARRAY_BUFFER, cur_msh.m_normalbuffer);
-        glBufferData(GL_ARRAY_BUFFER, msh.normal.size() * 3 * sizeof(float), msh.normal.data(),
-                     GL_DYNAMIC_DRAW);
+        m_backend->bufferData(GL_ARRAY_BUFFER, stream_regions * gl_mdl.m_region_size, nullptr,
+                              GL_STREAM_DRAW);
+        m_backend->bufferSubData(GL_ARRAY_BUFFER, gl_mdl.m_stream_offset, gl_mdl.m_region_size,
+                                 vertices.data());
+    }
+    else if(gl_mdl.m_streamed)
+    {
+        m_backend->bufferData(GL_ARRAY_BUFFER, gl_mdl.m_region_size, vertices.data(), GL_STREAM_DRAW);
+    }
 
-        glGenBuffers(1, &cur_msh.m_uvbuffer);
-        glBindBuffer(GL_ARRAY_BUFFER, cur_msh.m_uvbuffer);
-        glBufferData(GL_ARRAY_BUFFER, msh.tex_coords.size() * 2 * sizeof(float), msh.tex_coords.data(),
-                     GL_STATIC_DRAW);
+    // 16 bit indices while the rebased ones fit, the padding keeps the
+    // index arena aligned for 32 bit models
+    std::vector<uint16_t> short_indices;
+    void const *          index_data = indices.data();
 
-        // Generate a buffer for the indices as well
-        glGenBuffers(1, &cur_msh.m_elementbuffer);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cur_msh.m_elementbuffer);
-        cur_msh.m_indices_size = static_cast<GLsizei>(msh.indexes.size());
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, msh.indexes.size() * sizeof(uint32_t), msh.indexes.data(),
-                     GL_STATIC_DRAW);
+    if(std::all_of(mdl.meshes.begin(), mdl.meshes.end(), [](Mesh const & msh) { return msh.short_indices; })
+       && base_vertex + gl_mdl.m_num_vertices <= max_short_vertices)
+    {
+        short_indices.assign(indices.begin(), indices.end());
+        if(short_indices.size() % 2 != 0)
+            short_indices.push_back(0);
 
-        gl_mdl.model.push_back(cur_msh);
+        gl_mdl.m_index_width = sizeof(uint16_t);
+        gl_mdl.m_index_size  = static_cast<uint32_t>(short_indices.size() * sizeof(uint16_t));
+        index_data           = short_indices.data();
+    }
+    else
+    {
+        gl_mdl.m_index_width = sizeof(uint32_t);
+        gl_mdl.m_index_size  = static_cast<uint32_t>(indices.size() * sizeof(uint32_t));
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    auto const range = arenaUpload(m_index_arena, GL_ELEMENT_ARRAY_BUFFER, gl_mdl.m_index_size, index_data);
+
+    gl_mdl.m_elementbuffer = range.buffer;
+    gl_mdl.m_index_offset  = range.offset;
+    for(auto & msh : gl_mdl.model)
+        msh.m_first_index += range.offset / gl_mdl.m_index_width;
+
+    if(!streamed && !mdl.mesh_name.empty())
+    {
+        gl_mdl.m_shared_name = mdl.mesh_name;
+        m_shared_meshes[mdl.mesh_name] = {gl_mdl, 1};
+    }
 
     m_reg.add_component<RenderModel>(entity_id, gl_mdl);
 }
 
-void Renderer::draw(Entity entity_id) const
+void Renderer::drawModel(cmd::DrawModel const & mdl, RenderModel::mesh const * meshes) const
 {
-    auto const & mdl = m_reg.get<RenderModel>(entity_id);
+    GLsizei const stride     = sizeof(RenderModel::vertex);
+    size_t const  base       = mdl.stream_offset;
+    GLenum const  index_type = mdl.index_width == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    setClientState({true, true, true});
+    bindArrayBuffer(mdl.vertexbuffer);
 
-    for(auto const & msh : mdl.model)
+    // tangent space isn't used by the fixed function pipeline, it only
+    // widens the stride
+    if(m_arrays_source != mdl.vertexbuffer || m_arrays_offset != mdl.stream_offset)
     {
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-        glEnableClientState(GL_NORMAL_ARRAY);
+        auto const attrib = [base](size_t offset) { return reinterpret_cast<void *>(base + offset); };
 
-        glBindBuffer(GL_ARRAY_BUFFER, msh.m_normalbuffer);
-        glNormalPointer(GL_FLOAT, 0, static_cast<void *>(nullptr));
-        glBindBuffer(GL_ARRAY_BUFFER, msh.m_uvbuffer);
-        glTexCoordPointer(2, GL_FLOAT, 0, static_cast<void *>(nullptr));
-        glBindBuffer(GL_ARRAY_BUFFER, msh.m_vertexbuffer);
-        glVertexPointer(3, GL_FLOAT, 0, static_cast<void *>(nullptr));
+        m_backend->vertexPointer(3, GL_FLOAT, stride, attrib(offsetof(RenderModel::vertex, pos)));
+        m_backend->normalPointer(GL_FLOAT, stride, attrib(offsetof(RenderModel::vertex, normal)));
+        m_backend->texCoordPointer(2, GL_FLOAT, stride, attrib(offsetof(RenderModel::vertex, uv)));
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, msh.m_elementbuffer);
+        m_arrays_source = mdl.vertexbuffer;
+        m_arrays_offset = mdl.stream_offset;
+        m_stats.issued += 3;
+    }
+    else
+    {
+        m_stats.elided += 3;
+    }
 
-        glDrawElements(GL_TRIANGLES, msh.m_indices_size, GL_UNSIGNED_INT, static_cast<void *>(nullptr));
+    bindElementBuffer(mdl.elementbuffer);
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-        glDisableClientState(GL_NORMAL_ARRAY);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    for(uint32_t i = 0; i < mdl.num_meshes; ++i)
+    {
+        m_backend->drawElements(GL_TRIANGLES, meshes[i].m_indices_size, index_type,
+                                reinterpret_cast<void *>(meshes[i].m_first_index * mdl.index_width));
     }
 }
 
@@ -346,62 +625,75 @@ void Renderer::unloadModel(Entity entity_id) const
 
     auto & mdl = m_reg.get<RenderModel>(entity_id);
 
-    for(auto & msh : mdl.model)
+    if(!mdl.m_shared_name.empty())
     {
-        glDeleteBuffers(1, &msh.m_vertexbuffer);
-        glDeleteBuffers(1, &msh.m_normalbuffer);
-        glDeleteBuffers(1, &msh.m_uvbuffer);
-        glDeleteBuffers(1, &msh.m_elementbuffer);
+        auto it = m_shared_meshes.find(mdl.m_shared_name);
+        if(it != m_shared_meshes.end() && --it->second.ref_count > 0)
+        {
+            mdl = RenderModel();
+            return;
+        }
 
-        msh.m_vertexbuffer = msh.m_normalbuffer = msh.m_uvbuffer = msh.m_elementbuffer = msh.m_indices_size =
-            0;
+        m_shared_meshes.erase(mdl.m_shared_name);
     }
-}
 
-void Renderer::drawBBox(Entity entity_id) const
-{
-    auto const & ent_scn = m_reg.get<SceneComponent>(entity_id);
-    // auto const & ent_mdl = m_reg.get<ModelComponent>(entity_id);
-
-    if(!ent_scn.transformed_bbox)
-        return;
+    // arena pages stay alive until terminate
+    if(mdl.m_streamed)
+    {
+        m_backend->deleteBuffers(1, &mdl.m_vertexbuffer);
+        forgetBuffer(mdl.m_vertexbuffer);
+    }
+    else
+    {
+        m_vertex_arena.free({mdl.m_vertexbuffer, mdl.m_vertex_offset, mdl.m_region_size});
+    }
 
-    glm::vec3 size   = ent_scn.transformed_bbox->max() - ent_scn.transformed_bbox->min();
-    glm::vec3 center = (ent_scn.transformed_bbox->min() + ent_scn.transformed_bbox->max()) / 2.0f;
-    glm::mat4 transform =
-        glm::inverse(ent_scn.abs) * glm::translate(glm::mat4(1), center) * glm::scale(glm::mat4(1), size);
+    m_index_arena.free({mdl.m_elementbuffer, mdl.m_index_offset, mdl.m_index_size});
 
-    glDisable(GL_LIGHTING);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glMultMatrixf(glm::value_ptr(transform));
+    mdl = RenderModel();
+}
 
-    glColor3f(0.0f, 1.0f, 0.0f);
+void Renderer::drawBBox(glm::mat4 const & transform) const
+{
+    lighting(false);
+    setMatrixMode(MatrixType::MODELVIEW);
+    m_backend->pushMatrix();
+    m_backend->multMatrix(glm::value_ptr(transform));
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_bbox_vbo_vertices);
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glVertexPointer(4,          // number of elements per vertex, here (x,y,z,w));
-                    GL_FLOAT,   // the type of each element
-                    0,          // no extra data between each position
-                    0           // offset of first element
-    );
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_bbox_ibo_elements);
+    m_backend->color3f(0.0f, 1.0f, 0.0f);
 
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(1, 0);
-    glLineWidth(3);
+    setClientState({true, false, false});
+    bindArrayBuffer(m_bbox_vbo_vertices);
+    if(m_arrays_source != m_bbox_vbo_vertices || m_arrays_offset != 0)
+    {
+        m_backend->vertexPointer(4,          // number of elements per vertex, here (x,y,z,w));
+                                 GL_FLOAT,   // the type of each element
+                                 0,          // no extra data between each position
+                                 0           // offset of first element
+        );
+
+        m_arrays_source = m_bbox_vbo_vertices;
+        m_arrays_offset = 0;
+        m_stats.issued++;
+    }
+    else
+    {
+        m_stats.elided++;
+    }
+    bindElementBuffer(m_bbox_ibo_elements);
 
-    glDrawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, 0);
-    glDrawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, reinterpret_cast<GLvoid *>(4 * sizeof(GLushort)));
-    glDrawElements(GL_LINES, 8, GL_UNSIGNED_SHORT, reinterpret_cast<GLvoid *>(8 * sizeof(GLushort)));
+    m_backend->enable(GL_POLYGON_OFFSET_FILL);
+    m_backend->polygonOffset(1, 0);
+    m_backend->lineWidth(3);
 
-    glDisable(GL_POLYGON_OFFSET_FILL);
+    m_backend->drawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, 0);
+    m_backend->drawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT,
+                            reinterpret_cast<GLvoid *>(4 * sizeof(GLushort)));
+    m_backend->drawElements(GL_LINES, 8, GL_UNSIGNED_SHORT, reinterpret_cast<GLvoid *>(8 * sizeof(GLushort)));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_backend->disable(GL_POLYGON_OFFSET_FILL);
 
-    glPopMatrix();
+    m_backend->popMatrix();
 
     // model box
     //    size   = ent_mdl.base_bbox.max() - ent_mdl.base_bbox.min();
@@ -441,93 +733,424 @@ void Renderer::drawBBox(Entity entity_id) const
 
     //    glPopMatrix();
 
-    glLineWidth(1);
-    glEnable(GL_LIGHTING);
+    m_backend->lineWidth(1);
+}
+
+void Renderer::setClientState(ClientState const & new_state) const
+{
+    auto const toggle = [this](bool & current, bool enable, GLenum array) {
+        if(current == enable)
+        {
+            m_stats.elided++;
+            return;
+        }
+
+        current = enable;
+        m_stats.issued++;
+        if(enable)
+            m_backend->enableClientState(array);
+        else
+            m_backend->disableClientState(array);
+    };
+
+    toggle(m_client.vertex_array, new_state.vertex_array, GL_VERTEX_ARRAY);
+    toggle(m_client.normal_array, new_state.normal_array, GL_NORMAL_ARRAY);
+    toggle(m_client.tex_coord_array, new_state.tex_coord_array, GL_TEXTURE_COORD_ARRAY);
+}
+
+void Renderer::bindArrayBuffer(uint32_t buffer_id) const
+{
+    if(m_array_buffer == buffer_id)
+    {
+        m_stats.elided++;
+        return;
+    }
+
+    m_array_buffer = buffer_id;
+    m_stats.issued++;
+    m_backend->bindBuffer(GL_ARRAY_BUFFER, buffer_id);
+}
+
+void Renderer::bindElementBuffer(uint32_t buffer_id) const
+{
+    if(m_element_buffer == buffer_id)
+    {
+        m_stats.elided++;
+        return;
+    }
+
+    m_element_buffer = buffer_id;
+    m_stats.issued++;
+    m_backend->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer_id);
+}
+
+BufferArena::Range Renderer::arenaUpload(BufferArena & arena, uint32_t target, uint32_t size,
+                                         void const * data) const
+{
+    auto const bind = [this, target](uint32_t buffer_id) {
+        if(target == GL_ARRAY_BUFFER)
+            bindArrayBuffer(buffer_id);
+        else
+            bindElementBuffer(buffer_id);
+    };
+
+    BufferArena::Range range;
+    if(size == 0)
+        return range;
+
+    if(!arena.allocate(size, range))
+    {
+        uint32_t const page_size = arena.getPageSize(size);
+        uint32_t       page      = 0;
+
+        m_backend->genBuffers(1, &page);
+        bind(page);
+        m_backend->bufferData(target, page_size, nullptr, GL_STATIC_DRAW);
+        arena.addPage(page, page_size);
+
+        // the new page holds at least the allocation
+        [[maybe_unused]] bool const allocated = arena.allocate(size, range);
+        assert(allocated);
+    }
+
+    bind(range.buffer);
+    m_backend->bufferSubData(target, range.offset, range.size, data);
+
+    return range;
+}
+
+void Renderer::bindTexture(uint32_t texture_id) const
+{
+    if(m_texture == texture_id)
+    {
+        m_stats.elided++;
+        return;
+    }
+
+    m_texture = texture_id;
+    m_stats.issued++;
+    m_backend->bindTexture(GL_TEXTURE_2D, texture_id);
+}
+
+void Renderer::setMatrixMode(MatrixType type) const
+{
+    if(m_matrix_mode == type)
+    {
+        m_stats.elided++;
+        return;
+    }
+
+    m_matrix_mode = type;
+    m_stats.issued++;
+    m_backend->matrixMode(type == MatrixType::PROJECTION ? GL_PROJECTION : GL_MODELVIEW);
+}
+
+void Renderer::forgetBuffer(uint32_t buffer_id) const
+{
+    if(m_array_buffer == buffer_id)
+        m_array_buffer = 0;
+    if(m_element_buffer == buffer_id)
+        m_element_buffer = 0;
+    // a new buffer may get the same name
+    if(m_arrays_source == buffer_id)
+        m_arrays_source = 0;
+}
+
+void Renderer::beginStreamFrame()
+{
+    // orphaned buffers get new storage from the driver on every upload
+    if(!m_map_buffer_range)
+        return;
+
+    // the previous frame has been drawn from the current region
+    if(m_backend->hasSync())
+    {
+        if(m_region_fences[m_stream_region] != nullptr)
+            m_backend->deleteSync(m_region_fences[m_stream_region]);
+
+        m_region_fences[m_stream_region] = m_backend->fenceSync();
+    }
+
+    m_stream_region = (m_stream_region + 1) % stream_regions;
+    ++m_stream_frame;
+
+    // the fence of the region was set at the end of its last frame, without
+    // fences the ring relies on the driver queueing fewer frames than regions
+    m_synced_frame = m_stream_frame > stream_regions ? m_stream_frame - stream_regions : 0;
+    if(m_region_fences[m_stream_region] != nullptr)
+    {
+        m_backend->clientWaitSync(m_region_fences[m_stream_region]);
+        m_backend->deleteSync(m_region_fences[m_stream_region]);
+        m_region_fences[m_stream_region] = nullptr;
+    }
+}
+
+void Renderer::accountMemory(MemoryReport & report) const
+{
+    for(auto ent : m_reg.view<RenderModel>())
+    {
+        auto const & gl_mdl = m_reg.get<RenderModel>(ent);
+
+        report.add(MemTag::Render, VectorBytes(gl_mdl.model) + gl_mdl.m_shared_name.capacity());
+        if(gl_mdl.m_streamed)
+        {
+            uint64_t const size = uint64_t{gl_mdl.m_region_size} * (m_map_buffer_range ? stream_regions : 1);
+
+            report.gpu_buffer_bytes += size;
+            report.gpu_buffer_used += size;
+        }
+    }
+
+    for(auto const & [name, shared] : m_shared_meshes)
+        report.add(MemTag::Render, sizeof(shared) + name.capacity() + VectorBytes(shared.model.model));
+
+    for(auto const * arena : {&m_vertex_arena, &m_index_arena})
+    {
+        report.gpu_buffer_bytes += arena->getCapacity();
+        report.gpu_buffer_used += arena->getUsed();
+    }
+
+    for(auto const & tex : m_texture_bytes)
+        report.gpu_texture_bytes += tex.second;
+}
+
+void Renderer::streamModels(std::vector<Entity> const & models)
+{
+    beginStreamFrame();
+    for(auto ent : models)
+    {
+        if(!m_reg.has<RenderModel>(ent))
+            continue;
+
+        auto & gl_mdl = m_reg.get<RenderModel>(ent);
+        if(gl_mdl.m_skin_dirty)
+            streamModel(ent);
+
+        // the queued models are drawn this frame
+        if(gl_mdl.m_streamed && m_map_buffer_range)
+            gl_mdl.m_drawn_frames[gl_mdl.m_stream_offset / gl_mdl.m_region_size] = m_stream_frame;
+    }
+}
+
+void Renderer::streamModel(Entity entity_id)
+{
+    auto const & geom   = m_reg.get<ModelComponent>(entity_id);
+    auto &       gl_mdl = m_reg.get<RenderModel>(entity_id);
+    uint8_t *    dst    = nullptr;
+
+    if(!gl_mdl.m_streamed || geom.skin_mats.empty())
+        return;
+
+    gl_mdl.m_skin_dirty = false;
+
+    bindArrayBuffer(gl_mdl.m_vertexbuffer);
+    if(m_map_buffer_range)
+    {
+        // no implicit sync if the model hasn't drawn from the region since the
+        // frame the ring waited for, a model that skipped streams may have
+        uint32_t access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        if(gl_mdl.m_drawn_frames[m_stream_region] <= m_synced_frame)
+            access |= GL_MAP_UNSYNCHRONIZED_BIT;
+
+        gl_mdl.m_stream_offset = m_stream_region * gl_mdl.m_region_size;
+
+        dst = static_cast<uint8_t *>(m_backend->mapBufferRange(GL_ARRAY_BUFFER, gl_mdl.m_stream_offset,
+                                                               gl_mdl.m_region_size, access));
+    }
+    else
+    {
+        // orphan, the old storage lives until the pending draws are done
+        m_backend->bufferData(GL_ARRAY_BUFFER, gl_mdl.m_region_size, nullptr, GL_STREAM_DRAW);
+        dst = static_cast<uint8_t *>(m_backend->mapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+    }
+
+    if(dst == nullptr)
+        return;
+
+    // vertices past the prefix of the lod are left stale, nothing draws them
+    gl_mdl.m_skinned_lod = std::min(geom.lod, gl_mdl.m_num_lods - 1);
+
+    for(auto const & msh : geom.meshes)
+    {
+        SkinnedStream stream;
+        stream.pos       = dst + offsetof(RenderModel::vertex, pos);
+        stream.normal    = dst + offsetof(RenderModel::vertex, normal);
+        stream.uv        = dst + offsetof(RenderModel::vertex, uv);
+        stream.tangent   = dst + offsetof(RenderModel::vertex, tangent);
+        stream.bitangent = dst + offsetof(RenderModel::vertex, bitangent);
+        stream.stride    = sizeof(RenderModel::vertex);
+
+        ModelSystem::SkinMesh(msh, geom.skin_mats, stream,
+                              ModelSystem::GetLodVertices(msh, gl_mdl.m_skinned_lod));
+        dst += msh.pos.size() * sizeof(RenderModel::vertex);
+    }
+
+    // the contents are rewritten next frame if the store was lost
+    m_backend->unmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void Renderer::execute(CommandBuffer const & cmds) const
+{
+    CommandBuffer::Reader reader(cmds);
+
+    FrameVector<RenderModel::mesh> meshes;
+    while(!reader.atEnd())
+    {
+        switch(reader.nextType())
+        {
+            case cmd::Type::Clear:
+                reader.read<cmd::Clear>();
+                clearBuffers();
+                break;
+            case cmd::Type::SetMatrix:
+            {
+                auto const packet = reader.read<cmd::SetMatrix>();
+                setMatrix(packet.matrix_type, packet.matrix);
+                break;
+            }
+            case cmd::Type::LoadIdentity:
+                loadIdentityMatrix(reader.read<cmd::LoadIdentity>().matrix_type);
+                break;
+            case cmd::Type::Lighting:
+                lighting(reader.read<cmd::Lighting>().enable);
+                break;
+            case cmd::Type::BindLight:
+            {
+                auto const packet = reader.read<cmd::BindLight>();
+                bindLight(packet.light, packet.light_num);
+                break;
+            }
+            case cmd::Type::UnbindLight:
+                unbindLight(reader.read<cmd::UnbindLight>().light_num);
+                break;
+            case cmd::Type::BindMaterial:
+                bindMaterial(reader.read<cmd::BindMaterial>());
+                break;
+            case cmd::Type::DrawModel:
+            {
+                auto const packet = reader.read<cmd::DrawModel>();
+
+                meshes.clear();
+                for(uint32_t i = 0; i < packet.num_meshes; ++i)
+                    meshes.push_back(reader.read<RenderModel::mesh>());
+
+                drawModel(packet, meshes.data());
+                break;
+            }
+            case cmd::Type::DrawBBox:
+                drawBBox(reader.read<cmd::DrawBBox>().transform);
+                break;
+        }
+    }
 }
 
 void Renderer::clearColorBuffer() const
 {
-    glClearColor(m_clear_color[0], m_clear_color[1], m_clear_color[2], m_clear_color[3]);
-    glClear(GL_COLOR_BUFFER_BIT);
+    m_backend->clearColor(m_clear_color[0], m_clear_color[1], m_clear_color[2], m_clear_color[3]);
+    m_backend->clear(GL_COLOR_BUFFER_BIT);
 }
 
 void Renderer::clearDepthBuffer() const
 {
-    glClearDepth(m_clear_depth);
-    glClear(GL_DEPTH_BUFFER_BIT);
+    m_backend->clearDepth(m_clear_depth);
+    m_backend->clear(GL_DEPTH_BUFFER_BIT);
 }
 
 void Renderer::clearStencilBuffer() const
 {
-    glClearStencil(m_clear_stencil);
-    glClear(GL_STENCIL_BUFFER_BIT);
+    m_backend->clearStencil(m_clear_stencil);
+    m_backend->clear(GL_STENCIL_BUFFER_BIT);
 }
 
 void Renderer::clearBuffers() const
 {
-    glClearColor(m_clear_color[0], m_clear_color[1], m_clear_color[2], m_clear_color[3]);
-    glClearDepth(m_clear_depth);
-    glClearStencil(m_clear_stencil);
+    m_backend->clearColor(m_clear_color[0], m_clear_color[1], m_clear_color[2], m_clear_color[3]);
+    m_backend->clearDepth(m_clear_depth);
+    m_backend->clearStencil(m_clear_stencil);
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    m_backend->clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
 void Renderer::setViewport(int32_t x_pos, int32_t y_pos, int32_t width, int32_t height) const
 {
-    glViewport(x_pos, y_pos, width, height);
+    m_backend->viewport(x_pos, y_pos, width, height);
 }
 
 void Renderer::setAlphaState(AlphaState const & new_state)
 {
     if(m_alpha == new_state)
+    {
+        m_stats.elided += CountCalls(new_state);
         return;
+    }
 
     m_alpha = new_state;
+    m_stats.issued += CountCalls(new_state);
     commitAlphaState();
 }
 
 void Renderer::setCullState(CullState const & new_state)
 {
     if(m_cull == new_state)
+    {
+        m_stats.elided += CountCalls(new_state);
         return;
+    }
 
     m_cull = new_state;
+    m_stats.issued += CountCalls(new_state);
     commitCullState();
 }
 
 void Renderer::setDepthState(DepthState const & new_state)
 {
     if(m_depth == new_state)
+    {
+        m_stats.elided += CountCalls(new_state);
         return;
+    }
 
     m_depth = new_state;
+    m_stats.issued += CountCalls(new_state);
     commitDepthState();
 }
 
 void Renderer::setOffsetState(OffsetState const & new_state)
 {
     if(m_offset == new_state)
+    {
+        m_stats.elided += CountCalls(new_state);
         return;
+    }
 
     m_offset = new_state;
+    m_stats.issued += CountCalls(new_state);
     commitOffsetState();
 }
 
 void Renderer::setStencilState(StencilState const & new_state)
 {
     if(m_stencil == new_state)
+    {
+        m_stats.elided += CountCalls(new_state);
         return;
+    }
 
     m_stencil = new_state;
+    m_stats.issued += CountCalls(new_state);
     commitStencilState();
 }
 
 void Renderer::setWireState(WireState const & new_state)
 {
     if(m_wire == new_state)
+    {
+        m_stats.elided += CountCalls(new_state);
         return;
+    }
 
     m_wire = new_state;
+    m_stats.issued += CountCalls(new_state);
     commitWireState();
 }
 
@@ -538,26 +1161,26 @@ void Renderer::commitAlphaState() const
         GLenum src_blend = g_gl_alpha_src_blend[static_cast<uint32_t>(m_alpha.src_blend)];
         GLenum dst_blend = g_gl_alpha_dst_blend[static_cast<uint32_t>(m_alpha.dst_blend)];
 
-        glEnable(GL_BLEND);
-        glBlendFunc(src_blend, dst_blend);
-        glBlendColor(m_alpha.constant_color[0], m_alpha.constant_color[1], m_alpha.constant_color[2],
+        m_backend->enable(GL_BLEND);
+        m_backend->blendFunc(src_blend, dst_blend);
+        m_backend->blendColor(m_alpha.constant_color[0], m_alpha.constant_color[1], m_alpha.constant_color[2],
                      m_alpha.constant_color[3]);
     }
     else
     {
-        glDisable(GL_BLEND);
+        m_backend->disable(GL_BLEND);
     }
 
     if(m_alpha.compare_enabled)
     {
         GLenum compare = g_gl_compare_mode[static_cast<uint32_t>(m_alpha.compare)];
 
-        glEnable(GL_ALPHA_TEST);
-        glAlphaFunc(compare, m_alpha.reference);
+        m_backend->enable(GL_ALPHA_TEST);
+        m_backend->alphaFunc(compare, m_alpha.reference);
     }
     else
     {
-        glDisable(GL_ALPHA_TEST);
+        m_backend->disable(GL_ALPHA_TEST);
     }
 }
 
@@ -565,18 +1188,18 @@ void Renderer::commitCullState() const
 {
     if(m_cull.enabled)
     {
-        glEnable(GL_CULL_FACE);
-        glFrontFace(GL_CCW);
+        m_backend->enable(GL_CULL_FACE);
+        m_backend->frontFace(GL_CCW);
 
         bool order = m_cull.ccw_order;
         if(order)
-            glCullFace(GL_BACK);
+            m_backend->cullFace(GL_BACK);
         else
-            glCullFace(GL_FRONT);
+            m_backend->cullFace(GL_FRONT);
     }
     else
     {
-        glDisable(GL_CULL_FACE);
+        m_backend->disable(GL_CULL_FACE);
     }
 }
 
@@ -586,67 +1209,64 @@ void Renderer::commitDepthState() const
     {
         GLenum compare = g_gl_compare_mode[static_cast<uint32_t>(m_depth.compare)];
 
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(compare);
+        m_backend->enable(GL_DEPTH_TEST);
+        m_backend->depthFunc(compare);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        m_backend->disable(GL_DEPTH_TEST);
     }
 
-    if(m_depth.writable)
-        glDepthMask(GL_TRUE);
-    else
-        glDepthMask(GL_FALSE);
+    m_backend->depthMask(m_depth.writable);
 }
 
 void Renderer::commitOffsetState() const
 {
     if(m_offset.fill_enabled)
-        glEnable(GL_POLYGON_OFFSET_FILL);
+        m_backend->enable(GL_POLYGON_OFFSET_FILL);
     else
-        glDisable(GL_POLYGON_OFFSET_FILL);
+        m_backend->disable(GL_POLYGON_OFFSET_FILL);
 
     if(m_offset.line_enabled)
-        glEnable(GL_POLYGON_OFFSET_LINE);
+        m_backend->enable(GL_POLYGON_OFFSET_LINE);
     else
-        glDisable(GL_POLYGON_OFFSET_LINE);
+        m_backend->disable(GL_POLYGON_OFFSET_LINE);
 
     if(m_offset.point_enabled)
-        glEnable(GL_POLYGON_OFFSET_POINT);
+        m_backend->enable(GL_POLYGON_OFFSET_POINT);
     else
-        glDisable(GL_POLYGON_OFFSET_POINT);
+        m_backend->disable(GL_POLYGON_OFFSET_POINT);
 
-    glPolygonOffset(m_offset.scale, m_offset.bias);
+    m_backend->polygonOffset(m_offset.scale, m_offset.bias);
 }
 
 void Renderer::commitStencilState() const
 {
     if(m_stencil.enabled)
     {
-        glEnable(GL_STENCIL_TEST);
+        m_backend->enable(GL_STENCIL_TEST);
 
         GLenum compare   = g_gl_compare_mode[static_cast<uint32_t>(m_stencil.compare)];
         GLenum on_fail   = g_gl_stencil_operation[static_cast<uint32_t>(m_stencil.on_fail)];
         GLenum on_z_fail = g_gl_stencil_operation[static_cast<uint32_t>(m_stencil.on_z_fail)];
         GLenum on_z_pass = g_gl_stencil_operation[static_cast<uint32_t>(m_stencil.on_z_pass)];
 
-        glStencilFunc(compare, m_stencil.reference, m_stencil.mask);
-        glStencilMask(m_stencil.write_mask);
-        glStencilOp(on_fail, on_z_fail, on_z_pass);
+        m_backend->stencilFunc(compare, m_stencil.reference, m_stencil.mask);
+        m_backend->stencilMask(m_stencil.write_mask);
+        m_backend->stencilOp(on_fail, on_z_fail, on_z_pass);
     }
     else
     {
-        glDisable(GL_STENCIL_TEST);
+        m_backend->disable(GL_STENCIL_TEST);
     }
 }
 
 void Renderer::commitWireState() const
 {
     if(m_wire.enabled)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        m_backend->polygonMode(GL_FRONT_AND_BACK, GL_LINE);
     else
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        m_backend->polygonMode(GL_FRONT_AND_BACK, GL_FILL);
 }
 
 void Renderer::commitAllStates() const
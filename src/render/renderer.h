@@ -1,25 +1,75 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "bufferarena.h"
 #include "render_states.h"
+#include "renderbackend.h"
 #include "../scene/sceneentitybuilder.h"
 #include "../scene/AABB.h"
 
-// simple openGL 1.5 renderer
+// simple openGL 1.5 renderer, the GL calls go through a RenderBackend
+
+class CommandBuffer;
+struct LightComponent;
+struct MemoryReport;
 
+namespace cmd
+{
+struct BindMaterial;
+struct DrawModel;
+}   // namespace cmd
+
+// all meshes of a model share one interleaved vertex range and one index
+// range suballocated from the renderer buffer arenas, indices are rebased to
+// the start of the arena page so models in the same page share the vertex
+// array pointers
 struct RenderModel
 {
-    struct mesh
+    // regions of a streamed vertex buffer, a region isn't rewritten while
+    // the GPU may still read it for one of the previous frames
+    static constexpr uint32_t stream_regions = 3;
+
+    struct vertex
     {
-        uint32_t m_vertexbuffer  = 0;
-        uint32_t m_uvbuffer      = 0;
-        uint32_t m_normalbuffer  = 0;
-        uint32_t m_elementbuffer = 0;
+        glm::vec3 pos;
+        glm::vec3 normal;
+        glm::vec2 uv;
+        glm::vec3 tangent;
+        glm::vec3 bitangent;
+    };
 
-        int32_t m_indices_size = 0;
+    struct mesh
+    {
+        uint32_t m_first_index  = 0;
+        int32_t  m_indices_size = 0;
     };
 
-    std::vector<mesh> model;
+    uint32_t m_vertexbuffer  = 0;   // arena page, streamed models have their own buffer
+    uint32_t m_elementbuffer = 0;   // arena page
+    uint32_t m_vertex_offset = 0;   // bytes into the page
+    uint32_t m_index_offset  = 0;
+    uint32_t m_index_size    = 0;
+    uint32_t m_index_width   = sizeof(uint32_t);   // bytes, 2 if every index fits
+    uint32_t m_num_vertices  = 0;
+    // skinned models stream into a region of the vertex buffer in the frames
+    // they are visible
+    bool     m_streamed      = false;
+    uint32_t m_region_size   = 0;
+    uint32_t m_stream_offset = 0;       // region used by the current frame
+    uint32_t m_skinned_lod   = 0;       // the region holds the vertices of this lod and coarser ones
+    bool     m_skin_dirty    = false;   // skin matrices changed since the last stream
+    uint32_t m_num_lods      = 1;
+    // per region the last stream frame the model was drawn from it in
+    std::array<uint64_t, stream_regions> m_drawn_frames = {};
+    // static models with the same mesh share their buffers, empty for own buffers
+    std::string m_shared_name;
+
+    std::vector<mesh> model;   // meshes of lod 0, then of lod 1 and so on
 };
 
 class Renderer : public ISystem
@@ -31,31 +81,61 @@ public:
         MODELVIEW
     };
 
-    Renderer(Registry & reg) : ISystem(reg) {}
+    static constexpr uint32_t stream_regions = RenderModel::stream_regions;
+    // what happens to the CPU copies of static meshes and of file textures
+    // after the upload, released data is read again if the context is lost
+    enum class Residency
+    {
+        Keep,
+        ReleaseStatic
+    };
+
+    // arena page sizes
+    static constexpr uint32_t arena_page_vertices = 1u << 16;
+    static constexpr uint32_t arena_page_indices  = 1u << 20;
+    // models past this vertex of their page use 32 bit indices
+    static constexpr uint32_t max_short_vertices = 1u << 16;
+
+    Renderer(Registry & reg, std::unique_ptr<RenderBackend> backend) :
+        ISystem(reg), m_backend(std::move(backend))
+    {}
 
     // ModelSystem must be updated before renderer
     void        update(double time) override;   /// if needed upload new data to GPU
     bool        init() override;
     std::string getName() const override { return "Renderer"; }
     void        terminate() override;
+    // forgets every GL object without deleting it and marks the models for
+    // a reload, call before init() on the new context
+    void contextLost();
+
+    void      setResidency(Residency residency) { m_residency = residency; }
+    Residency getResidency() const { return m_residency; }
 
     void setMatrix(MatrixType type, glm::mat4 const & matrix) const;
     void loadIdentityMatrix(MatrixType type) const;
 
     void uploadMaterialData(Entity entity_id) const;
-    void bindMaterial(Entity entity_id) const;
+    void bindMaterial(cmd::BindMaterial const & mat) const;
     void unloadMaterialData(Entity entity_id) const;
 
     void lighting(bool enable = true) const;
-    void bindLight(Entity entity_id, uint32_t light_num = 0) const;
+    void bindLight(LightComponent const & lgh, uint32_t light_num = 0) const;
     void unbindLight(uint32_t light_num = 0) const;
 
     void uploadModel(Entity entity_id) const;
-    void draw(Entity entity_id) const;
+    // skins and uploads the queued models with changed poses, after culling
+    void streamModels(std::vector<Entity> const & models);
+    // adds the render side copies and the GPU storage
+    void accountMemory(MemoryReport & report) const;
+    void drawModel(cmd::DrawModel const & mdl, RenderModel::mesh const * meshes) const;
     void unloadModel(Entity entity_id) const;
 
-    // debug draw
-    void drawBBox(Entity entity_id) const;
+    // debug draw, transform of the unit cube relative to the modelview matrix
+    void drawBBox(glm::mat4 const & transform) const;
+
+    // replays a recorded frame
+    void execute(CommandBuffer const & cmds) const;
 
     // Access to the current clearing parameters for the color, depth, and
     // stencil buffers.
@@ -84,7 +164,28 @@ public:
     void setStencilState(StencilState const & new_state);
     void setWireState(WireState const & new_state);
 
+    // Shadowed state, GL is only called when the value actually changes.
+    void setClientState(ClientState const & new_state) const;
+    void bindArrayBuffer(uint32_t buffer_id) const;
+    void bindElementBuffer(uint32_t buffer_id) const;
+    void bindTexture(uint32_t texture_id) const;
+
+    StateStats const & getStateStats() const { return m_stats; }
+    void               resetStateStats() { m_stats = StateStats(); }
+
+    RenderBackend & getBackend() const { return *m_backend; }
+
 private:
+    void setMatrixMode(MatrixType type) const;
+    void resetStateShadow() const;   // to the GL defaults
+    void forgetBuffer(uint32_t buffer_id) const;   // after glDeleteBuffers
+    // suballocates and uploads, creates a page when the arena is full
+    BufferArena::Range arenaUpload(BufferArena & arena, uint32_t target, uint32_t size,
+                                   void const * data) const;
+
+    void beginStreamFrame();
+    void streamModel(Entity entity_id);
+
     void commitAlphaState() const;
     void commitCullState() const;
     void commitDepthState() const;
@@ -93,6 +194,8 @@ private:
     void commitWireState() const;
     void commitAllStates() const;
 
+    std::unique_ptr<RenderBackend> m_backend;
+
     // states
     AlphaState   m_alpha;
     CullState    m_cull;
@@ -105,11 +208,58 @@ private:
     float     m_clear_depth   = 1.0f;
     int32_t   m_clear_stencil = 0;
 
+    // shadow of the GL state that changes per draw, it starts with the GL defaults
+    mutable ClientState m_client;
+    mutable uint32_t    m_array_buffer   = 0;
+    mutable uint32_t    m_element_buffer = 0;
+    mutable uint32_t    m_arrays_source  = 0;   // buffer and offset the array pointers were set from
+    mutable uint32_t    m_arrays_offset  = 0;
+    mutable uint32_t    m_texture        = 0;
+    mutable bool        m_lighting       = false;
+    mutable MatrixType  m_matrix_mode    = MatrixType::MODELVIEW;
+
+    mutable glm::vec4 m_bound_ambient   = glm::vec4(0.0f);
+    mutable glm::vec4 m_bound_diffuse   = glm::vec4(0.0f);
+    mutable glm::vec4 m_bound_specular  = glm::vec4(0.0f);
+    mutable float     m_bound_shininess = 0.0f;
+    mutable bool      m_material_bound  = false;
+
+    mutable StateStats m_stats;
+
+    struct SharedBuffers
+    {
+        RenderModel model;
+        uint32_t    ref_count = 0;
+    };
+
+    struct SharedTextures
+    {
+        uint32_t base_tex_id = 0;
+        uint32_t bump_tex_id = 0;
+        uint32_t ref_count   = 0;
+    };
+
+    mutable std::unordered_map<std::string, SharedBuffers>  m_shared_meshes;
+    mutable std::unordered_map<std::string, SharedTextures> m_shared_textures;
+    mutable std::unordered_map<uint32_t, uint64_t>          m_texture_bytes;   // per texture id
+
+    mutable BufferArena m_vertex_arena{
+        static_cast<uint32_t>(arena_page_vertices * sizeof(RenderModel::vertex))};
+    mutable BufferArena m_index_arena{static_cast<uint32_t>(arena_page_indices * sizeof(uint32_t))};
+
+    // skinned vertex streaming
+    bool                               m_map_buffer_range = false;   // false: orphan the whole buffer
+    uint32_t                           m_stream_region    = 0;
+    std::array<void *, stream_regions> m_region_fences    = {};   // GLsync per region
+    uint64_t                           m_stream_frame     = 0;    // frames begun, 0 before the first
+    uint64_t                           m_synced_frame     = 0;    // done with the region up to this frame
+
     // bbox vbo
     uint32_t m_bbox_vbo_vertices = 0;
     uint32_t m_bbox_ibo_elements = 0;
 
-    bool m_terminated = false;
+    Residency m_residency  = Residency::ReleaseStatic;
+    bool      m_terminated = false;
 };
 
 #endif
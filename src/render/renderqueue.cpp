@@ -0,0 +1,169 @@
+#include "renderqueue.h"
+#include <cstring>
+
+#include "renderer.h"
+#include "../scene/material.h"
+#include "../scene/scenecmp.h"
+
+namespace
+{
+constexpr uint32_t radix_bits    = 8;
+constexpr uint32_t radix_buckets = 1u << radix_bits;
+constexpr uint32_t radix_passes  = 64 / radix_bits;
+
+// mesh key: 6 bits of the vertex buffer name, enough to tell the arena pages
+// apart, and 10 bits of the start vertex in the page
+constexpr uint32_t mesh_offset_bits = 10;
+constexpr uint32_t mesh_offset_mask = (1u << mesh_offset_bits) - 1;
+constexpr uint32_t mesh_page_mask   = (1u << (16 - mesh_offset_bits)) - 1;
+
+void HashBytes(uint64_t & hash, void const * data, size_t size)
+{
+    // FNV-1a
+    auto const * bytes = static_cast<uint8_t const *>(data);
+    for(size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+}   // namespace
+
+void RenderQueue::build(std::vector<Entity> const & models, glm::mat4 const & view_mat)
+{
+    m_items.clear();
+
+    for(auto node : models)
+    {
+        uint16_t material = 0;
+        uint16_t texture  = 0;
+        uint16_t mesh     = 0;
+
+        if(m_reg.has<MaterialComponent>(node))
+        {
+            material = MaterialHash(node, m_reg);
+            texture  = static_cast<uint16_t>(m_reg.get<MaterialComponent>(node).m_base_tex_id);
+        }
+
+        if(m_reg.has<RenderModel>(node))
+        {
+            // the page in the high bits, models of one page share the vertex
+            // pointers, below it the start vertex folded so one mesh keeps one key
+            auto const & gl_mdl = m_reg.get<RenderModel>(node);
+            auto const   page   = gl_mdl.m_vertexbuffer & mesh_page_mask;
+            auto const   vertex = static_cast<uint32_t>(gl_mdl.m_vertex_offset / sizeof(RenderModel::vertex));
+
+            mesh = static_cast<uint16_t>((page << mesh_offset_bits)
+                                         | ((vertex ^ (vertex >> mesh_offset_bits)) & mesh_offset_mask));
+        }
+
+        auto const & world = m_reg.get<WorldTransformComponent>(node);
+        float const  depth = -(view_mat * glm::vec4(world.abs.origin(), 1.0f)).z;
+
+        m_items.push_back({BuildKey(material, texture, mesh, depth), node});
+    }
+
+    RadixSort(m_items, m_sort_buffer);
+
+    m_batches.clear();
+    m_instances.clear();
+    for(auto const & item : m_items)
+    {
+        if(m_batches.empty() || !sameInstance(m_instances.back(), item.entity))
+            m_batches.push_back({static_cast<uint32_t>(m_instances.size()), 0});
+
+        m_instances.push_back(item.entity);
+        m_batches.back().count++;
+    }
+}
+
+uint64_t RenderQueue::BuildKey(uint16_t material, uint16_t texture, uint16_t mesh, float depth)
+{
+    // the upper half of a positive float keeps its order, nodes behind the
+    // camera are sorted first
+    uint32_t depth_bits = 0;
+    if(depth > 0.0f)
+        std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+
+    return (static_cast<uint64_t>(material) << 48) | (static_cast<uint64_t>(texture) << 32)
+           | (static_cast<uint64_t>(mesh) << 16) | static_cast<uint64_t>(depth_bits >> 16);
+}
+
+uint16_t RenderQueue::MaterialHash(Entity entity_id, Registry const & reg)
+{
+    // only the parameters set by Renderer::bindMaterial
+    auto const & mat  = reg.get<MaterialComponent>(entity_id);
+    uint64_t     hash = 14695981039346656037ull;
+
+    HashBytes(hash, &mat.m_ambient, sizeof(mat.m_ambient));
+    HashBytes(hash, &mat.m_diffuse, sizeof(mat.m_diffuse));
+    HashBytes(hash, &mat.m_specular, sizeof(mat.m_specular));
+    HashBytes(hash, &mat.m_shininess, sizeof(mat.m_shininess));
+
+    return static_cast<uint16_t>(hash ^ (hash >> 16) ^ (hash >> 32) ^ (hash >> 48));
+}
+
+bool RenderQueue::sameInstance(Entity lhs, Entity rhs) const
+{
+    if(!m_reg.has<RenderModel>(lhs) || !m_reg.has<RenderModel>(rhs))
+        return false;
+
+    auto const & lhs_mdl = m_reg.get<RenderModel>(lhs);
+    auto const & rhs_mdl = m_reg.get<RenderModel>(rhs);
+
+    // skinned models have their own buffers, static ones share arena pages
+    if(lhs_mdl.m_streamed || rhs_mdl.m_streamed || lhs_mdl.m_vertexbuffer != rhs_mdl.m_vertexbuffer
+       || lhs_mdl.m_vertex_offset != rhs_mdl.m_vertex_offset
+       || lhs_mdl.m_elementbuffer != rhs_mdl.m_elementbuffer
+       || lhs_mdl.m_index_offset != rhs_mdl.m_index_offset)
+        return false;
+
+    if(!m_reg.has<MaterialComponent>(lhs) || !m_reg.has<MaterialComponent>(rhs))
+        return false;
+
+    auto const & lhs_mat = m_reg.get<MaterialComponent>(lhs);
+    auto const & rhs_mat = m_reg.get<MaterialComponent>(rhs);
+
+    return lhs_mat.m_base_tex_id == rhs_mat.m_base_tex_id && lhs_mat.m_ambient == rhs_mat.m_ambient
+           && lhs_mat.m_diffuse == rhs_mat.m_diffuse && lhs_mat.m_specular == rhs_mat.m_specular
+           && lhs_mat.m_shininess == rhs_mat.m_shininess;
+}
+
+void RenderQueue::RadixSort(std::vector<Item> & items, std::vector<Item> & tmp)
+{
+    if(items.size() < 2)
+        return;
+
+    // histograms for every pass in one sweep
+    uint32_t counts[radix_passes][radix_buckets] = {};
+    for(auto const & item : items)
+    {
+        for(uint32_t pass = 0; pass < radix_passes; ++pass)
+            ++counts[pass][(item.key >> (pass * radix_bits)) & (radix_buckets - 1)];
+    }
+
+    tmp.resize(items.size());
+    auto const num_items = static_cast<uint32_t>(items.size());
+
+    for(uint32_t pass = 0; pass < radix_passes; ++pass)
+    {
+        uint32_t const shift = pass * radix_bits;
+
+        // all keys share this digit
+        if(counts[pass][(items[0].key >> shift) & (radix_buckets - 1)] == num_items)
+            continue;
+
+        uint32_t offset = 0;
+        for(uint32_t bucket = 0; bucket < radix_buckets; ++bucket)
+        {
+            uint32_t const count = counts[pass][bucket];
+            counts[pass][bucket] = offset;
+            offset += count;
+        }
+
+        for(auto const & item : items)
+            tmp[counts[pass][(item.key >> shift) & (radix_buckets - 1)]++] = item;
+
+        items.swap(tmp);
+    }
+}
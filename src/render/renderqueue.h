@@ -0,0 +1,55 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../scene/sceneentitybuilder.h"
+
+// Draw list sorted by state so that consecutive draws share material,
+// texture and vertex buffers. Sort key layout from the most significant bits:
+//      [16 material hash] [16 texture] [16 mesh] [16 depth]
+// depth is ordered front to back, inside the same state opaque draws benefit
+// from early z rejection. Runs of models sharing mesh buffers and material
+// are grouped into batches, FrameBuilder::record binds the material once per
+// batch.
+class RenderQueue
+{
+public:
+    struct Item
+    {
+        uint64_t key;
+        Entity   entity;
+    };
+
+    struct Batch
+    {
+        uint32_t first = 0;   // into getInstances()
+        uint32_t count = 0;
+    };
+
+    RenderQueue(Registry & reg) : m_reg(reg) {}
+
+    // fill from the visible models and sort them
+    void                        build(std::vector<Entity> const & models, glm::mat4 const & view_mat);
+    std::vector<Item> const &   getItems() const { return m_items; }
+    std::vector<Batch> const &  getBatches() const { return m_batches; }
+    std::vector<Entity> const & getInstances() const { return m_instances; }
+
+    static uint64_t BuildKey(uint16_t material, uint16_t texture, uint16_t mesh, float depth);
+    static uint16_t MaterialHash(Entity entity_id, Registry const & reg);
+    // stable LSD radix sort on the key, tmp is used as a scratch buffer
+    static void RadixSort(std::vector<Item> & items, std::vector<Item> & tmp);
+
+private:
+    bool sameInstance(Entity lhs, Entity rhs) const;   // exact check, keys may collide
+
+    Registry &          m_reg;
+    std::vector<Item>   m_items;
+    std::vector<Item>   m_sort_buffer;
+    std::vector<Batch>  m_batches;
+    std::vector<Entity> m_instances;
+};
+
+#endif   // RENDERQUEUE_H
@@ -59,6 +59,16 @@ struct TGAHEADER
 
 namespace tex
 {
+uint64_t GetImageBytes(ImageData const & id)
+{
+    if(!id.data)
+        return 0;
+
+    uint64_t const bpp = id.type == ImageData::PixelType::pt_rgb ? 3 : 4;
+
+    return uint64_t{id.width} * id.height * bpp;
+}
+
 //==============================================================================
 //         Read BMP section
 //==============================================================================
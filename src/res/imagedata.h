@@ -23,6 +23,9 @@ struct ImageData
     std::unique_ptr<uint8_t[]> data;
 };
 
+// bytes of the pixel data
+uint64_t GetImageBytes(ImageData const & id);
+
 bool ReadBMP(std::string const & file_name, ImageData & id);
 bool ReadTGA(std::string const & file_name, ImageData & id);
 
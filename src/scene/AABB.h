@@ -8,6 +8,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <limits>
 #include <vector>
+#include "affine.h"
 
 namespace evnt
 {
@@ -210,6 +211,29 @@ public:
         //        buildBoundBox(corner_points);
     }
 
+    //! Transform this bounding box
+    /*! Same as transform(glm::mat4) for an affine transform, the box is
+        moved as center/half-extent pair so only one 3x3 product is needed
+        \param[in] tr affine transformation
+    */
+    inline void transform(Affine const & tr)
+    {
+        glm::vec3         center = (m_min + m_max) * 0.5f;
+        glm::vec3         extent = (m_max - m_min) * 0.5f;
+        glm::mat3 const & basis  = tr.basis();
+
+        glm::vec3 new_extent;
+        for(int i = 0; i < 3; i++)
+        {
+            new_extent[i] = glm::abs(basis[0][i]) * extent[0] + glm::abs(basis[1][i]) * extent[1]
+                            + glm::abs(basis[2][i]) * extent[2];
+        }
+        center = tr.transformPoint(center);
+
+        m_min = center - new_extent;
+        m_max = center + new_extent;
+    }
+
     /*! Build the bounding box to include the given coordinates.
         \param[in] positions point set for building AABB
     */
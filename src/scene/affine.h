@@ -0,0 +1,76 @@
+#ifndef AFFINE_H
+#define AFFINE_H
+
+#include <glm/glm.hpp>
+
+namespace evnt
+{
+//! Affine transformation stored as a 3x4 matrix
+/*!
+    Scene nodes never need the projective row of a 4x4 matrix, so the
+    transform is kept as a 3x3 basis (rotation, scale, shear) plus a
+    translation. It takes 48 bytes instead of 64 and the product of two
+    transforms costs 36 multiplies less than a full glm::mat4 product.
+*/
+class Affine
+{
+    glm::mat3 m_basis;  /*!< Columns are the transformed x, y and z axes */
+    glm::vec3 m_origin; /*!< Translation part */
+public:
+    //! Construct the identity transform
+    inline Affine() : m_basis(1.0f), m_origin(0.0f) {}
+
+    inline Affine(glm::mat3 const & basis, glm::vec3 const & origin) : m_basis(basis), m_origin(origin) {}
+
+    //! Drop the projective row of the given matrix
+    inline explicit Affine(glm::mat4 const & mat) : m_basis(mat), m_origin(mat[3]) {}
+
+    inline glm::mat3 const & basis() const { return m_basis; }
+
+    inline glm::vec3 const & origin() const { return m_origin; }
+
+    inline glm::mat4 toMat4() const
+    {
+        glm::mat4 mat(m_basis);
+        mat[3] = glm::vec4(m_origin, 1.0f);
+
+        return mat;
+    }
+
+    inline glm::vec3 transformPoint(glm::vec3 const & p) const { return m_basis * p + m_origin; }
+
+    inline glm::vec3 transformVector(glm::vec3 const & v) const { return m_basis * v; }
+
+    //! Same result as toMat4() * v
+    inline glm::vec4 operator*(glm::vec4 const & v) const
+    {
+        return glm::vec4(m_basis * glm::vec3(v) + m_origin * v.w, v.w);
+    }
+
+    //! Concatenate transforms, rhs is applied first
+    inline Affine operator*(Affine const & rhs) const
+    {
+        return Affine(m_basis * rhs.m_basis, m_basis * rhs.m_origin + m_origin);
+    }
+
+    inline Affine inverse() const
+    {
+        glm::mat3 inv_basis = glm::inverse(m_basis);
+
+        return Affine(inv_basis, -(inv_basis * m_origin));
+    }
+
+    // weighted sum for linear blend skinning
+    inline Affine operator*(float w) const { return Affine(m_basis * w, m_origin * w); }
+
+    inline Affine & operator+=(Affine const & rhs)
+    {
+        m_basis += rhs.m_basis;
+        m_origin += rhs.m_origin;
+
+        return *this;
+    }
+};
+}   // namespace evnt
+
+#endif   // AFFINE_H
@@ -0,0 +1,368 @@
+#include "assetcache.h"
+#include <array>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+#include "model.h"
+#include "src/utils/allocstats.h"
+#include "src/utils/binarystream.h"
+#include "src/utils/mappedfile.h"
+
+namespace
+{
+constexpr uint32_t blob_magic   = 0x4d525950;   // "PYRM"
+constexpr uint32_t blob_version = 3;
+constexpr size_t   num_sources  = 4;   // mesh, animation, diffuse and bump textures
+
+// 0 for a missing source, an animation is optional
+int64_t GetFileTime(std::string const & fname)
+{
+    std::error_code ec;
+    auto const      time = std::filesystem::last_write_time(fname, ec);
+    return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+uint64_t HashName(std::string const & str, uint64_t hash)
+{
+    // FNV-1a
+    for(char c : str)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+void WriteBbox(BinaryWriter & out, evnt::AABB const & bbox)
+{
+    out.write(bbox.min());
+    out.write(bbox.max());
+}
+
+bool ReadBbox(BinaryReader & in, evnt::AABB & bbox)
+{
+    glm::vec3 min, max;
+    if(!in.read(min) || !in.read(max))
+        return false;
+
+    bbox = evnt::AABB(min, max);
+    return true;
+}
+
+void WriteAffine(BinaryWriter & out, evnt::Affine const & affine)
+{
+    out.write(affine.basis());
+    out.write(affine.origin());
+}
+
+bool ReadAffine(BinaryReader & in, evnt::Affine & affine)
+{
+    glm::mat3 basis;
+    glm::vec3 origin;
+    if(!in.read(basis) || !in.read(origin))
+        return false;
+
+    affine = evnt::Affine(basis, origin);
+    return true;
+}
+
+void WriteImage(BinaryWriter & out, tex::ImageData const & image)
+{
+    out.write(image.width);
+    out.write(image.height);
+    out.write(image.type);
+    out.write<uint8_t>(image.data ? 1 : 0);
+    if(image.data)
+        out.writeBytes(image.data.get(), tex::GetImageBytes(image));
+}
+
+bool ReadImage(BinaryReader & in, tex::ImageData & image)
+{
+    uint8_t has_data = 0;
+    if(!in.read(image.width) || !in.read(image.height) || !in.read(image.type) || !in.read(has_data))
+        return false;
+
+    image.data.reset();
+    if(has_data == 0)
+        return true;
+
+    // as GetImageBytes, which counts allocated data only
+    uint64_t const bpp   = image.type == tex::ImageData::PixelType::pt_rgb ? 3 : 4;
+    uint64_t const bytes = uint64_t{image.width} * image.height * bpp;
+    if(bytes > in.getRemaining())
+        return false;
+
+    image.data.reset(new uint8_t[bytes]);
+    return in.readBytes(image.data.get(), bytes);
+}
+
+void WriteMesh(BinaryWriter & out, Mesh const & msh)
+{
+    out.writeVector(msh.pos);
+    out.writeVector(msh.normal);
+    out.writeVector(msh.tangent);
+    out.writeVector(msh.bitangent);
+
+    // std::pair isn't trivially copyable
+    out.write<uint64_t>(msh.weight_indxs.size());
+    for(auto const & range : msh.weight_indxs)
+    {
+        out.write(range.first);
+        out.write(range.second);
+    }
+
+    out.writeVector(msh.weights);
+    out.writeVector(msh.tex_coords);
+    out.writeVector(msh.indexes);
+    out.write<uint8_t>(msh.short_indices ? 1 : 0);
+
+    out.write<uint64_t>(msh.lods.size());
+    for(auto const & lod : msh.lods)
+    {
+        out.writeVector(lod.indexes);
+        out.write(lod.num_vertices);
+    }
+
+    WriteBbox(out, msh.bbox);
+}
+
+bool ReadMesh(BinaryReader & in, Mesh & msh)
+{
+    uint64_t num_ranges = 0;
+    if(!in.readVector(msh.pos) || !in.readVector(msh.normal) || !in.readVector(msh.tangent)
+       || !in.readVector(msh.bitangent) || !in.read(num_ranges) || num_ranges > msh.pos.size())
+        return false;
+
+    msh.weight_indxs.resize(static_cast<size_t>(num_ranges));
+    for(auto & range : msh.weight_indxs)
+    {
+        if(!in.read(range.first) || !in.read(range.second))
+            return false;
+    }
+
+    uint8_t  short_indices = 0;
+    uint64_t num_lods      = 0;
+    if(!in.readVector(msh.weights) || !in.readVector(msh.tex_coords) || !in.readVector(msh.indexes)
+       || !in.read(short_indices) || !in.read(num_lods) || num_lods > msh.indexes.size())
+        return false;
+
+    msh.short_indices = short_indices != 0;
+    msh.lods.resize(static_cast<size_t>(num_lods));
+    for(auto & lod : msh.lods)
+    {
+        if(!in.readVector(lod.indexes) || !in.read(lod.num_vertices))
+            return false;
+    }
+
+    return ReadBbox(in, msh.bbox);
+}
+
+// the blob is of this version and no source has changed since it was written
+bool ReadHeader(BinaryReader & in)
+{
+    uint32_t magic = 0, version = 0;
+    if(!in.read(magic) || !in.read(version) || magic != blob_magic || version != blob_version)
+        return false;
+
+    for(size_t i = 0; i < num_sources; ++i)
+    {
+        std::string source;
+        int64_t     time = 0;
+        if(!in.readString(source) || !in.read(time) || GetFileTime(source) != time)
+            return false;
+    }
+
+    return true;
+}
+
+void WriteAnimation(BinaryWriter & out, AnimSequence const & seq)
+{
+    out.write(seq.frame_rate);
+    out.write<uint64_t>(seq.frames.size());
+    for(auto const & frame : seq.frames)
+    {
+        WriteBbox(out, frame.bbox);
+        out.writeVector(frame.rot);
+        out.writeVector(frame.trans);
+    }
+}
+
+bool ReadAnimation(BinaryReader & in, AnimSequence & seq)
+{
+    uint64_t num_frames = 0;
+    if(!in.read(seq.frame_rate) || !in.read(num_frames) || seq.frame_rate <= 0.0f)
+        return false;
+
+    // a frame takes at least its bbox
+    if(num_frames > in.getRemaining() / (2 * sizeof(glm::vec3)))
+        return false;
+
+    seq.frames.resize(static_cast<size_t>(num_frames));
+    for(auto & frame : seq.frames)
+    {
+        if(!ReadBbox(in, frame.bbox) || !in.readVector(frame.rot) || !in.readVector(frame.trans))
+            return false;
+    }
+
+    // as ModelSystem::LoadAnim sets it up
+    seq.controller = Controller(Controller::RepeatType::RT_WRAP, 0.0f,
+                                static_cast<double>(seq.frames.size()) / seq.frame_rate);
+    return true;
+}
+}   // namespace
+
+std::string AssetCache::GetModelBlobName(std::string const & fname, std::string const & anim_fname,
+                                         std::string const & mat_fname)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash          = HashName(fname, hash);
+    hash          = HashName("\n" + anim_fname, hash);
+    hash          = HashName("\n" + mat_fname, hash);
+
+    std::ostringstream name;
+    name << fname << '.' << std::hex << std::setw(16) << std::setfill('0') << hash << ".mdl";
+    return name.str();
+}
+
+bool AssetCache::ReadModelBlob(std::string const & blob_fname, ModelData & out)
+{
+    MappedFile file;
+    if(!file.open(blob_fname))
+        return false;
+
+    BinaryReader in(file.getData(), file.getSize());
+    if(!ReadHeader(in))
+        return false;
+
+    ModelData data;
+    auto &    mdl = data.mdl;
+    {
+        MemTagScope tag(MemTag::Mesh);
+
+        uint64_t num_ids = 0, num_meshes = 0, num_joints = 0;
+        if(!in.readString(mdl.material_name) || !in.readString(mdl.mesh_name) || !in.readString(mdl.anim_name)
+           || !in.read(mdl.num_lods) || !ReadBbox(in, mdl.base_bbox) || !in.read(num_ids)
+           || !in.read(num_meshes) || num_ids > in.getRemaining() || num_meshes > in.getRemaining())
+            return false;
+
+        mdl.joint_id_to_entity.resize(static_cast<size_t>(num_ids), null_entity_id);
+        mdl.meshes.resize(static_cast<size_t>(num_meshes));
+        for(auto & msh : mdl.meshes)
+        {
+            if(!ReadMesh(in, msh))
+                return false;
+        }
+
+        if(!in.read(num_joints) || num_joints > in.getRemaining())
+            return false;
+
+        data.joints.resize(static_cast<size_t>(num_joints));
+        for(auto & jnt : data.joints)
+        {
+            if(!in.read(jnt.index) || !in.read(jnt.parent) || !in.readString(jnt.name)
+               || !ReadAffine(in, jnt.inv_bind))
+                return false;
+        }
+    }
+
+    {
+        MemTagScope tag(MemTag::Animation);
+
+        uint64_t num_anims = 0;
+        if(!in.read(num_anims) || num_anims > in.getRemaining())
+            return false;
+
+        mdl.animations.resize(static_cast<size_t>(num_anims));
+        for(auto & seq : mdl.animations)
+        {
+            if(!ReadAnimation(in, seq))
+                return false;
+        }
+    }
+
+    {
+        MemTagScope tag(MemTag::Image);
+
+        uint8_t animated = 0;
+        auto &  mat      = data.mat;
+        if(!in.read(animated) || !in.readString(mat.m_diff_fname) || !in.readString(mat.m_bump_fname)
+           || !ReadImage(in, mat.m_diff) || !ReadImage(in, mat.m_bump) || !in.isEnd())
+            return false;
+
+        data.animated = animated != 0;
+    }
+
+    out = std::move(data);
+    return true;
+}
+
+bool AssetCache::IsModelBlobCurrent(std::string const & blob_fname)
+{
+    MappedFile file;
+    if(!file.open(blob_fname))
+        return false;
+
+    BinaryReader in(file.getData(), file.getSize());
+    return ReadHeader(in);
+}
+
+bool AssetCache::WriteModelBlob(std::string const & blob_fname, ModelData const & data)
+{
+    auto const & mdl = data.mdl;
+
+    BinaryWriter out;
+    out.write(blob_magic);
+    out.write(blob_version);
+    std::array<std::string const *, num_sources> const sources{
+        &mdl.mesh_name, &mdl.anim_name, &data.mat.m_diff_fname, &data.mat.m_bump_fname};
+    for(auto const * source : sources)
+    {
+        out.writeString(*source);
+        out.write(GetFileTime(*source));
+    }
+
+    out.writeString(mdl.material_name);
+    out.writeString(mdl.mesh_name);
+    out.writeString(mdl.anim_name);
+    out.write(mdl.num_lods);
+    WriteBbox(out, mdl.base_bbox);
+    out.write<uint64_t>(mdl.joint_id_to_entity.size());
+    out.write<uint64_t>(mdl.meshes.size());
+    for(auto const & msh : mdl.meshes)
+        WriteMesh(out, msh);
+
+    out.write<uint64_t>(data.joints.size());
+    for(auto const & jnt : data.joints)
+    {
+        out.write(jnt.index);
+        out.write(jnt.parent);
+        out.writeString(jnt.name);
+        WriteAffine(out, jnt.inv_bind);
+    }
+
+    out.write<uint64_t>(mdl.animations.size());
+    for(auto const & seq : mdl.animations)
+        WriteAnimation(out, seq);
+
+    out.write<uint8_t>(data.animated ? 1 : 0);
+    out.writeString(data.mat.m_diff_fname);
+    out.writeString(data.mat.m_bump_fname);
+    WriteImage(out, data.mat.m_diff);
+    WriteImage(out, data.mat.m_bump);
+
+    return out.writeFile(blob_fname);
+}
+
+void AssetCache::ReadModel(std::string const & fname, std::string const & anim_fname,
+                           std::string const & mat_fname, ModelData & out)
+{
+    std::string const blob_fname = GetModelBlobName(fname, anim_fname, mat_fname);
+    if(ReadModelBlob(blob_fname, out))
+        return;
+
+    ModelSystem::ReadModel(fname, anim_fname, mat_fname, out);
+    // a read-only asset folder only costs the warm start
+    WriteModelBlob(blob_fname, out);
+}
@@ -0,0 +1,28 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <string>
+
+struct ModelData;
+
+// Imported models stored as binary blobs next to the mesh file: the mesh
+// after OptimizeMesh, the skeleton, the animation and the decoded textures.
+// A blob is mapped and copied out instead of parsing and optimizing the text
+// files again, it is rebuilt when a source file is newer than the blob.
+class AssetCache
+{
+public:
+    static std::string GetModelBlobName(std::string const & fname, std::string const & anim_fname,
+                                        std::string const & mat_fname);
+    // false if the blob is missing, stale or of another version
+    static bool ReadModelBlob(std::string const & blob_fname, ModelData & out);
+    // false where ReadModelBlob would fail on the header, the data isn't read
+    static bool IsModelBlobCurrent(std::string const & blob_fname);
+    static bool WriteModelBlob(std::string const & blob_fname, ModelData const & data);
+
+    // from the blob, or from the source files and then writes the blob
+    static void ReadModel(std::string const & fname, std::string const & anim_fname,
+                          std::string const & mat_fname, ModelData & out);
+};
+
+#endif   // ASSETCACHE_H
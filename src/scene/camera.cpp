@@ -20,15 +20,21 @@ CameraComponent CameraSystem::GetDefaultCamComponent()
     return new_cam;
 }
 
+CameraSystem::CameraSystem(Registry & reg) : ISystem(reg)
+{
+    m_transformed.connect<WorldTransformComponent, CameraComponent>(m_reg);
+}
+
 void CameraSystem::update(double time)
 {
-    for(auto ent : m_reg.view<SceneComponent, CameraComponent, Event::Scene::IsTransformed>())
+    for(auto ent : m_transformed)
     {
-        auto & pos = m_reg.get<SceneComponent>(ent);
+        auto & pos = m_reg.get<WorldTransformComponent>(ent);
         auto & cam = m_reg.get<CameraComponent>(ent);
 
         SetupViewMatrix(cam, pos.abs);
     }
+    m_transformed.clear();
 }
 
 void CameraSystem::SetupProjMatrix(CameraComponent & cam, float fov, float aspect, float near_plane,
@@ -54,10 +60,10 @@ void CameraSystem::SetupProjMatrix(CameraComponent & cam, float fov, float aspec
     cam.m_frustum.buildViewFrustum(cam.m_view_mat, cam.m_proj_mat);
 }
 
-void CameraSystem::SetupViewMatrix(CameraComponent & cam, glm::mat4 const & new_trans)
+void CameraSystem::SetupViewMatrix(CameraComponent & cam, evnt::Affine const & new_trans)
 {
-    cam.m_abs_pos  = glm::vec3(new_trans * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-    cam.m_view_mat = glm::inverse(new_trans);
+    cam.m_abs_pos  = new_trans.origin();
+    cam.m_view_mat = new_trans.inverse().toMat4();
 
     cam.m_frustum.buildViewFrustum(cam.m_view_mat, cam.m_proj_mat);
 }
@@ -1,6 +1,7 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
+#include "affine.h"
 #include "frustum.h"
 #include "sceneentitybuilder.h"
 
@@ -14,7 +15,7 @@ struct CameraComponent
     glm::ivec2    m_vp_pos;
     glm::ivec2    m_vp_size;
     float         m_frust_left, m_frust_right, m_frust_bottom, m_frust_top, m_frust_near, m_frust_far;
-    bool          m_orthographic;   // Perspective or orthographic frustum?
+    uint32_t      m_orthographic;   // Perspective or orthographic frustum? a bool without padding
 };
 
 class CameraSystem : public ISystem
@@ -23,13 +24,16 @@ public:
     static CameraComponent GetDefaultCamComponent();
     static void            SetupProjMatrix(CameraComponent & cam, float fov, float aspect, float near_plane,
                                            float far_plane);
-    static void            SetupViewMatrix(CameraComponent & cam, glm::mat4 const & new_trans);
+    static void            SetupViewMatrix(CameraComponent & cam, evnt::Affine const & new_trans);
 
-    CameraSystem(Registry & reg) : ISystem(reg) {}
+    CameraSystem(Registry & reg);
 
     // bool        init() override;
     void        update(double time) override;
     std::string getName() const override { return "Camera"; }
+
+private:
+    Observer m_transformed;   // cameras moved since the last update
 };
 
 #endif   // CAMERA_H
@@ -18,20 +18,26 @@ LightComponent LightSystem::GetDefaultLightComponent(LightType l_type)
     return cmp;
 }
 
+LightSystem::LightSystem(Registry & reg) : ISystem(reg)
+{
+    m_transformed.connect<WorldTransformComponent, LightComponent>(m_reg);
+}
+
 void LightSystem::update(double time)
 {
-    for(auto ent : m_reg.view<SceneComponent, LightComponent, Event::Scene::IsTransformed>())
+    for(auto ent : m_transformed)
     {
-        auto const & pos = m_reg.get<SceneComponent>(ent);
+        auto const & pos = m_reg.get<WorldTransformComponent>(ent);
         auto &       lgh = m_reg.get<LightComponent>(ent);
 
         if(lgh.type == LightType::Spot || lgh.type == LightType::Point)
         {
             lgh.position       = pos.abs * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-            lgh.spot_direction = glm::mat3(pos.abs) * lgh.spot_direction;
+            lgh.spot_direction = pos.abs.transformVector(lgh.spot_direction);
         }
 
         if(lgh.type == LightType::Directional)
             lgh.spot_direction = glm::vec3(pos.abs * glm::vec4(lgh.spot_direction, 0.0f));
     }
+    m_transformed.clear();
 }
@@ -29,10 +29,13 @@ class LightSystem : public ISystem
 public:
     static LightComponent GetDefaultLightComponent(LightType l_type = LightType::Point);
 
-    LightSystem(Registry & reg) : ISystem(reg) {}
+    LightSystem(Registry & reg);
 
     void        update(double time) override;
     std::string getName() const override { return "LightSystem"; }
+
+private:
+    Observer m_transformed;   // lights moved since the last update
 };
 
 #endif /* LIGHT_H */
@@ -1,6 +1,8 @@
 #include "material.h"
 #include <cstring>
 
+#include "src/utils/allocstats.h"
+
 MaterialComponent MaterialSystem::GetDefaultMaterialComponent()
 {
     static const uint8_t texData[] = {128, 192, 255, 255, 128, 192, 255, 255, 255, 192, 128, 255, 255,
@@ -38,6 +40,8 @@ MaterialComponent MaterialSystem::GetDefaultMaterialComponent()
 bool MaterialSystem::LoadTGA(MaterialComponent & mat, std::string const & base_fname,
                              std::string const & bump_fname)
 {
+    MemTagScope tag(MemTag::Image);
+
     if(!tex::ReadTGA(base_fname, mat.m_diff))
         return false;
 
@@ -45,5 +49,36 @@ bool MaterialSystem::LoadTGA(MaterialComponent & mat, std::string const & base_f
         if(!tex::ReadTGA(bump_fname, mat.m_bump))
             return false;
 
+    mat.m_diff_fname = base_fname;
+    mat.m_bump_fname = bump_fname;
+
+    return true;
+}
+
+uint64_t MaterialSystem::GetMemoryUsage(MaterialComponent const & mat)
+{
+    return tex::GetImageBytes(mat.m_diff) + tex::GetImageBytes(mat.m_bump) + mat.m_diff_fname.capacity()
+           + mat.m_bump_fname.capacity();
+}
+
+void MaterialSystem::ReleaseImages(MaterialComponent & mat)
+{
+    if(!mat.m_diff_fname.empty())
+        mat.m_diff.data.reset();
+
+    if(!mat.m_bump_fname.empty())
+        mat.m_bump.data.reset();
+}
+
+bool MaterialSystem::ReloadImages(MaterialComponent & mat)
+{
+    MemTagScope tag(MemTag::Image);
+
+    if(!mat.m_diff.data && !tex::ReadTGA(mat.m_diff_fname, mat.m_diff))
+        return false;
+
+    if(!mat.m_bump.data && !tex::ReadTGA(mat.m_bump_fname, mat.m_bump))
+        return false;
+
     return true;
 }
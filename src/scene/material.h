@@ -1,6 +1,7 @@
 #ifndef MATERIAL_H
 #define MATERIAL_H
 
+#include <string>
 #include <glm/glm.hpp>
 #include "../res/imagedata.h"
 
@@ -8,6 +9,9 @@ struct MaterialComponent
 {
     tex::ImageData m_diff;
     tex::ImageData m_bump;
+    // source files, materials loaded from the same files share GPU textures
+    std::string m_diff_fname;
+    std::string m_bump_fname;
 
     uint32_t m_base_tex_id;
     uint32_t m_bump_tex_id;
@@ -29,6 +33,12 @@ public:
 
     static bool LoadTGA(MaterialComponent & mat, std::string const & base_fname,
                         std::string const & bump_fname);
+    // bytes of the image copies and file names, see MemoryReport
+    static uint64_t GetMemoryUsage(MaterialComponent const & mat);
+
+    // frees the images loaded from files after the upload, built in ones stay
+    static void ReleaseImages(MaterialComponent & mat);
+    static bool ReloadImages(MaterialComponent & mat);
 };
 
 #endif /* MATERIAL_H */
@@ -0,0 +1,659 @@
+#include "meshopt.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "model.h"
+
+namespace
+{
+constexpr uint32_t cache_size     = 32;
+constexpr float    cache_decay    = 1.5f;
+constexpr float    last_tri_score = 0.75f;
+constexpr float    valence_scale  = 2.0f;
+constexpr float    valence_power  = 0.5f;
+constexpr uint32_t no_index       = std::numeric_limits<uint32_t>::max();
+
+// triangles of every lod relative to the full mesh, a level that removes
+// less than a tenth of the previous one ends the chain
+constexpr std::array<float, 3> lod_ratios        = {0.5f, 0.25f, 0.125f};
+constexpr float                lod_min_reduction = 0.9f;
+constexpr uint32_t             lod_min_triangles = 64;
+// the rms distance of a collapsed vertex to the planes it stands for stays
+// under this part of the mesh size
+constexpr double lod_max_error = 0.05;
+// collapsing vertices with fully different skin weights costs as much as
+// moving them by this part of the mesh size
+constexpr double skin_weight_penalty = 0.05;
+
+float VertexScore(int32_t cache_pos, uint32_t active_tris)
+{
+    // no triangles left, the vertex can't pull anything in
+    if(active_tris == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if(cache_pos >= 0)
+    {
+        // vertices of the last triangle get a fixed score, otherwise its
+        // immediate neighbours would always win
+        if(cache_pos < 3)
+            score = last_tri_score;
+        else
+            score = std::pow(1.0f - static_cast<float>(cache_pos - 3) / (cache_size - 3), cache_decay);
+    }
+
+    // lone triangles are picked early instead of being left behind
+    return score + valence_scale * std::pow(static_cast<float>(active_tris), -valence_power);
+}
+
+// symmetric 4x4 plane quadric: a2 ab ac ad b2 bc bd c2 cd d2
+using Quadric = std::array<double, 10>;
+
+Quadric PlaneQuadric(glm::dvec3 const & n, double d, double weight)
+{
+    return {weight * n.x * n.x, weight * n.x * n.y, weight * n.x * n.z, weight * n.x * d,
+            weight * n.y * n.y, weight * n.y * n.z, weight * n.y * d,   weight * n.z * n.z,
+            weight * n.z * d,   weight * d * d};
+}
+
+void AddQuadric(Quadric & dst, Quadric const & src)
+{
+    for(uint32_t i = 0; i < dst.size(); ++i)
+        dst[i] += src[i];
+}
+
+double QuadricError(Quadric const & q, glm::dvec3 const & p)
+{
+    return q[0] * p.x * p.x + q[4] * p.y * p.y + q[7] * p.z * p.z
+           + 2.0 * (q[1] * p.x * p.y + q[2] * p.x * p.z + q[5] * p.y * p.z)
+           + 2.0 * (q[3] * p.x + q[6] * p.y + q[8] * p.z) + q[9];
+}
+
+// 0 for equal weights, 2 for weights on different joints
+double SkinDistance(Mesh const & msh, uint32_t a, uint32_t b)
+{
+    if(msh.weight_indxs.size() != msh.pos.size())
+        return 0.0;
+
+    auto const weight_of = [&msh](uint32_t v, uint32_t joint) {
+        for(uint32_t j = msh.weight_indxs[v].first; j < msh.weight_indxs[v].second; ++j)
+        {
+            if(msh.weights[j].joint_index == joint)
+                return static_cast<double>(msh.weights[j].w);
+        }
+        return 0.0;
+    };
+
+    double dist = 0.0;
+    for(uint32_t j = msh.weight_indxs[a].first; j < msh.weight_indxs[a].second; ++j)
+        dist += std::abs(msh.weights[j].w - weight_of(b, msh.weights[j].joint_index));
+    for(uint32_t j = msh.weight_indxs[b].first; j < msh.weight_indxs[b].second; ++j)
+    {
+        if(weight_of(a, msh.weights[j].joint_index) == 0.0)
+            dist += std::abs(msh.weights[j].w);
+    }
+
+    return dist;
+}
+
+// Collapses work on positions, vertices split by uv or normal seams share a
+// position class and move together. A collapse of class from into class to
+// moves every vertex of from onto a vertex of to it shares a triangle with,
+// or onto the one with the closest attributes.
+class Simplifier
+{
+public:
+    Simplifier(Mesh const & msh);
+
+    // collapses the cheapest edges until the mesh has target triangles or
+    // nothing can be collapsed anymore
+    void     simplify(uint32_t target);
+    uint32_t getNumTriangles() const { return static_cast<uint32_t>(m_indexes.size() / 3); }
+
+    std::vector<uint32_t> const & getIndexes() const { return m_indexes; }
+
+private:
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double   error;   // mean squared distance to the planes
+        double   cost;    // error and skin weight penalty
+    };
+
+    Mesh const &          m_msh;
+    std::vector<uint32_t> m_indexes;
+    std::vector<uint32_t> m_pos_class;   // vertex -> first vertex of the same position
+    std::vector<Quadric>  m_quadrics;    // per class
+    std::vector<double>   m_weights;     // per class, area the quadric is summed over
+    std::vector<uint32_t> m_remap;
+    double                m_penalty     = 0.0;
+    double                m_error_limit = 0.0;
+
+    uint32_t pass(uint32_t target);   // returns the number of collapses
+    uint32_t closestVertex(uint32_t v, uint32_t to_class, std::vector<uint32_t> const & tri_offset,
+                           std::vector<uint32_t> const & class_tris) const;
+};
+
+Simplifier::Simplifier(Mesh const & msh) :
+    m_msh(msh),
+    m_indexes(msh.indexes),
+    m_pos_class(msh.pos.size()),
+    m_quadrics(msh.pos.size(), Quadric{}),
+    m_weights(msh.pos.size(), 0.0),
+    m_remap(msh.pos.size())
+{
+    auto const num_vertices = static_cast<uint32_t>(msh.pos.size());
+
+    std::vector<uint32_t> order(num_vertices);
+    for(uint32_t v = 0; v < num_vertices; ++v)
+        order[v] = m_remap[v] = v;
+
+    auto const less = [&msh](uint32_t a, uint32_t b) {
+        auto const & pa = msh.pos[a];
+        auto const & pb = msh.pos[b];
+        return pa.x != pb.x ? pa.x < pb.x : (pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z);
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    glm::vec3 mins{std::numeric_limits<float>::max()}, maxs{std::numeric_limits<float>::lowest()};
+    for(uint32_t i = 0; i < num_vertices; ++i)
+    {
+        bool const same = i > 0 && msh.pos[order[i]] == msh.pos[order[i - 1]];
+        m_pos_class[order[i]] = same ? m_pos_class[order[i - 1]] : order[i];
+
+        mins = glm::min(mins, msh.pos[i]);
+        maxs = glm::max(maxs, msh.pos[i]);
+    }
+
+    double const size = num_vertices > 0 ? glm::length(glm::dvec3(maxs - mins)) : 0.0;
+    m_penalty         = (skin_weight_penalty * size) * (skin_weight_penalty * size);
+    m_error_limit     = (lod_max_error * size) * (lod_max_error * size);
+
+    // area weighted planes of the original triangles
+    for(uint32_t i = 0; i + 2 < m_indexes.size(); i += 3)
+    {
+        glm::dvec3 const p0(msh.pos[m_indexes[i]]);
+        glm::dvec3 const n  = glm::cross(glm::dvec3(msh.pos[m_indexes[i + 1]]) - p0,
+                                        glm::dvec3(msh.pos[m_indexes[i + 2]]) - p0);
+        double const     area = glm::length(n);
+        if(area == 0.0)
+            continue;
+
+        Quadric const q = PlaneQuadric(n / area, -glm::dot(n / area, p0), area * 0.5);
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            AddQuadric(m_quadrics[m_pos_class[m_indexes[i + k]]], q);
+            m_weights[m_pos_class[m_indexes[i + k]]] += area * 0.5;
+        }
+    }
+}
+
+void Simplifier::simplify(uint32_t target)
+{
+    while(getNumTriangles() > target && pass(target) > 0)
+    {}
+}
+
+uint32_t Simplifier::pass(uint32_t target)
+{
+    auto const num_vertices = static_cast<uint32_t>(m_msh.pos.size());
+    auto const num_tris     = getNumTriangles();
+    auto const cls          = [this](uint32_t corner) { return m_pos_class[m_indexes[corner]]; };
+
+    // triangles around every class
+    std::vector<uint32_t> tri_offset(num_vertices + 1, 0);
+    std::vector<uint32_t> class_tris(num_tris * 3);
+    for(uint32_t i = 0; i < num_tris * 3; ++i)
+        tri_offset[cls(i) + 1]++;
+    for(uint32_t v = 0; v < num_vertices; ++v)
+        tri_offset[v + 1] += tri_offset[v];
+
+    std::vector<uint32_t> fill(tri_offset.begin(), tri_offset.end() - 1);
+    for(uint32_t i = 0; i < num_tris * 3; ++i)
+        class_tris[fill[cls(i)]++] = i / 3;
+
+    // an edge used by one triangle is on the border, border vertices only
+    // move along the border so holes keep their outline
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(num_tris * 3);
+    for(uint32_t t = 0; t < num_tris; ++t)
+    {
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t const a = cls(t * 3 + k);
+            uint32_t const b = cls(t * 3 + (k + 1) % 3);
+            if(a != b)
+                edges.push_back({std::min(a, b), std::max(a, b)});
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<bool>     border(num_vertices, false);
+    std::vector<Collapse> collapses;
+    for(uint32_t i = 0; i < edges.size();)
+    {
+        uint32_t count = 1;
+        while(i + count < edges.size() && edges[i + count] == edges[i])
+            ++count;
+
+        if(count == 1)
+            border[edges[i].first] = border[edges[i].second] = true;
+
+        i += count;
+    }
+
+    for(uint32_t i = 0; i < edges.size();)
+    {
+        uint32_t count = 1;
+        while(i + count < edges.size() && edges[i + count] == edges[i])
+            ++count;
+
+        auto const [a, b]     = edges[i];
+        bool const on_border  = count == 1;
+        auto const add_cost   = [&](uint32_t from, uint32_t to) {
+            if(border[from] && !on_border)
+                return;
+
+            Quadric q = m_quadrics[from];
+            AddQuadric(q, m_quadrics[to]);
+
+            // divided by the area, a squared distance like the limit whatever the mesh scale
+            double const weight = m_weights[from] + m_weights[to];
+            double const error =
+                weight > 0.0 ? std::max(QuadricError(q, glm::dvec3(m_msh.pos[to])), 0.0) / weight : 0.0;
+            if(error > m_error_limit)
+                return;
+
+            collapses.push_back({from, to, error, error + m_penalty * SkinDistance(m_msh, from, to)});
+        };
+
+        add_cost(a, b);
+        add_cost(b, a);
+
+        i += count;
+    }
+
+    std::sort(collapses.begin(), collapses.end(),
+              [](Collapse const & lhs, Collapse const & rhs) { return lhs.cost < rhs.cost; });
+
+    // one collapse per neighbourhood and pass, the costs around a collapsed
+    // vertex are stale until the next pass
+    std::vector<bool>                          locked(num_vertices, false);
+    std::vector<std::pair<uint32_t, uint32_t>> vertex_map;
+    uint32_t                                   removed = 0, num_collapses = 0;
+
+    for(auto const & c : collapses)
+    {
+        if(num_tris - removed <= target)
+            break;
+        if(locked[c.from] || locked[c.to])
+            continue;
+
+        bool     valid     = true;
+        uint32_t collapsed = 0;
+
+        vertex_map.clear();
+        for(uint32_t i = tri_offset[c.from]; i < tri_offset[c.from + 1] && valid; ++i)
+        {
+            uint32_t const t  = class_tris[i];
+            uint32_t       to = no_index;
+            for(uint32_t k = 0; k < 3; ++k)
+            {
+                if(cls(t * 3 + k) == c.to)
+                    to = m_indexes[t * 3 + k];
+            }
+
+            if(to != no_index)
+            {
+                collapsed++;
+                for(uint32_t k = 0; k < 3; ++k)
+                {
+                    if(cls(t * 3 + k) == c.from)
+                        vertex_map.push_back({m_indexes[t * 3 + k], to});
+                }
+                continue;
+            }
+
+            // the remaining triangles must not flip
+            glm::dvec3 p[3], moved[3];
+            for(uint32_t k = 0; k < 3; ++k)
+            {
+                p[k]     = glm::dvec3(m_msh.pos[m_indexes[t * 3 + k]]);
+                moved[k] = cls(t * 3 + k) == c.from ? glm::dvec3(m_msh.pos[c.to]) : p[k];
+            }
+
+            glm::dvec3 const n_old = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::dvec3 const n_new = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+            valid                  = glm::dot(n_old, n_new) > 0.0;
+        }
+
+        if(!valid)
+            continue;
+
+        // vertices of a seam (flat shading, uv islands) away from the edge
+        // move onto the vertex of the other class with the closest normal
+        // and uv
+        for(uint32_t i = tri_offset[c.from]; i < tri_offset[c.from + 1]; ++i)
+        {
+            for(uint32_t k = 0; k < 3; ++k)
+            {
+                uint32_t const v = m_indexes[class_tris[i] * 3 + k];
+                if(m_pos_class[v] != c.from
+                   || std::any_of(vertex_map.begin(), vertex_map.end(),
+                                  [v](auto const & vm) { return vm.first == v; }))
+                    continue;
+
+                vertex_map.push_back({v, closestVertex(v, c.to, tri_offset, class_tris)});
+            }
+        }
+
+        for(auto const & [from, to] : vertex_map)
+            m_remap[from] = to;
+
+        AddQuadric(m_quadrics[c.to], m_quadrics[c.from]);
+        m_weights[c.to] += m_weights[c.from];
+
+        for(uint32_t i = tri_offset[c.from]; i < tri_offset[c.from + 1]; ++i)
+        {
+            for(uint32_t k = 0; k < 3; ++k)
+                locked[cls(class_tris[i] * 3 + k)] = true;
+        }
+
+        removed += collapsed;
+        num_collapses++;
+    }
+
+    // collapsed triangles are left with two corners at one position
+    std::vector<uint32_t> indexes;
+    indexes.reserve(m_indexes.size());
+    for(uint32_t t = 0; t < num_tris; ++t)
+    {
+        uint32_t const v0 = m_remap[m_indexes[t * 3]];
+        uint32_t const v1 = m_remap[m_indexes[t * 3 + 1]];
+        uint32_t const v2 = m_remap[m_indexes[t * 3 + 2]];
+
+        if(m_pos_class[v0] == m_pos_class[v1] || m_pos_class[v1] == m_pos_class[v2]
+           || m_pos_class[v0] == m_pos_class[v2])
+            continue;
+
+        indexes.insert(indexes.end(), {v0, v1, v2});
+    }
+
+    m_indexes.swap(indexes);
+
+    return num_collapses;
+}
+
+uint32_t Simplifier::closestVertex(uint32_t v, uint32_t to_class, std::vector<uint32_t> const & tri_offset,
+                                   std::vector<uint32_t> const & class_tris) const
+{
+    uint32_t best      = to_class;
+    float    best_dist = std::numeric_limits<float>::max();
+
+    for(uint32_t i = tri_offset[to_class]; i < tri_offset[to_class + 1]; ++i)
+    {
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t const w = m_indexes[class_tris[i] * 3 + k];
+            if(m_pos_class[w] != to_class)
+                continue;
+
+            glm::vec3 const dn   = m_msh.normal[v] - m_msh.normal[w];
+            glm::vec2 const duv  = m_msh.tex_coords[v] - m_msh.tex_coords[w];
+            float const     dist = glm::dot(dn, dn) + glm::dot(duv, duv);
+            if(dist < best_dist)
+            {
+                best      = w;
+                best_dist = dist;
+            }
+        }
+    }
+
+    return best;
+}
+
+template<typename T>
+void Permute(std::vector<T> & data, std::vector<uint32_t> const & new_to_old)
+{
+    if(data.size() != new_to_old.size())
+        return;
+
+    std::vector<T> out;
+    out.reserve(data.size());
+    for(auto const old_index : new_to_old)
+        out.push_back(data[old_index]);
+
+    data.swap(out);
+}
+}   // namespace
+
+void OptimizeMesh(Mesh & msh)
+{
+    auto const num_vertices = static_cast<uint32_t>(msh.pos.size());
+
+    if(std::any_of(msh.indexes.begin(), msh.indexes.end(),
+                   [num_vertices](uint32_t index) { return index >= num_vertices; }))
+        return;
+
+    GenerateLods(msh);
+
+    OptimizeVertexCache(msh.indexes, num_vertices);
+    for(auto & lod : msh.lods)
+        OptimizeVertexCache(lod.indexes, num_vertices);
+
+    OptimizeVertexFetch(msh);
+
+    msh.short_indices = num_vertices <= std::numeric_limits<uint16_t>::max() + 1u;
+}
+
+void GenerateLods(Mesh & msh)
+{
+    msh.lods.clear();
+
+    auto const num_tris = static_cast<uint32_t>(msh.indexes.size() / 3);
+    if(num_tris < lod_min_triangles)
+        return;
+
+    // every level continues from the previous one, so the vertices of a
+    // level are a subset of the vertices of the finer levels
+    Simplifier simplifier(msh);
+    uint32_t   prev_tris = num_tris;
+    for(auto const ratio : lod_ratios)
+    {
+        simplifier.simplify(static_cast<uint32_t>(static_cast<float>(num_tris) * ratio));
+
+        auto const lod_tris = simplifier.getNumTriangles();
+        if(lod_tris == 0 || static_cast<float>(lod_tris) > static_cast<float>(prev_tris) * lod_min_reduction)
+            break;
+
+        prev_tris = lod_tris;
+        msh.lods.push_back({simplifier.getIndexes(), 0});
+    }
+}
+
+void OptimizeVertexCache(std::vector<uint32_t> & indexes, uint32_t num_vertices)
+{
+    auto const num_tris = static_cast<uint32_t>(indexes.size() / 3);
+    if(num_tris == 0)
+        return;
+
+    // triangles of every vertex, the active ones are kept at the front
+    std::vector<uint32_t> active_tris(num_vertices, 0);
+    std::vector<uint32_t> adj_offset(num_vertices + 1, 0);
+    std::vector<uint32_t> adj(num_tris * 3);
+
+    for(uint32_t i = 0; i < num_tris * 3; ++i)
+        active_tris[indexes[i]]++;
+    for(uint32_t v = 0; v < num_vertices; ++v)
+        adj_offset[v + 1] = adj_offset[v] + active_tris[v];
+
+    std::vector<uint32_t> fill(adj_offset.begin(), adj_offset.end() - 1);
+    for(uint32_t i = 0; i < num_tris * 3; ++i)
+        adj[fill[indexes[i]]++] = i / 3;
+
+    std::vector<float> vertex_score(num_vertices);
+    std::vector<float> tri_score(num_tris, 0.0f);
+    std::vector<bool>  tri_added(num_tris, false);
+
+    for(uint32_t v = 0; v < num_vertices; ++v)
+        vertex_score[v] = VertexScore(-1, active_tris[v]);
+
+    uint32_t best_tri = 0;
+    for(uint32_t t = 0; t < num_tris; ++t)
+    {
+        for(uint32_t k = 0; k < 3; ++k)
+            tri_score[t] += vertex_score[indexes[t * 3 + k]];
+
+        if(tri_score[t] > tri_score[best_tri])
+            best_tri = t;
+    }
+
+    // triangle scores are the sum of their vertex scores
+    auto const rescore = [&](uint32_t v, int32_t pos) {
+        float const score = VertexScore(pos, active_tris[v]);
+        float const delta = score - vertex_score[v];
+
+        vertex_score[v] = score;
+        for(uint32_t i = adj_offset[v]; i < adj_offset[v] + active_tris[v]; ++i)
+            tri_score[adj[i]] += delta;
+    };
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> new_cache;
+    std::vector<uint32_t> out;
+    uint32_t              scan_pos = 0;
+
+    cache.reserve(cache_size + 3);
+    new_cache.reserve(cache_size + 3);
+    out.reserve(num_tris * 3);
+
+    for(uint32_t n = 0; n < num_tris; ++n)
+    {
+        // nothing left around the cache, continue with the next unused
+        // triangle in the source order to keep the whole pass linear
+        if(best_tri == no_index)
+        {
+            while(tri_added[scan_pos])
+                ++scan_pos;
+            best_tri = scan_pos;
+        }
+
+        uint32_t const * tri = &indexes[best_tri * 3];
+
+        tri_added[best_tri] = true;
+        new_cache.clear();
+        for(uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t const v = tri[k];
+
+            out.push_back(v);
+            new_cache.push_back(v);
+
+            auto const begin = adj.begin() + adj_offset[v];
+            auto const end   = begin + active_tris[v];
+            std::iter_swap(std::find(begin, end, best_tri), end - 1);
+            active_tris[v]--;
+        }
+
+        for(auto const v : cache)
+        {
+            if(v != tri[0] && v != tri[1] && v != tri[2])
+                new_cache.push_back(v);
+        }
+
+        cache.swap(new_cache);
+
+        // rescore everything whose cache position changed, vertices pushed
+        // out lose their position score
+        for(uint32_t i = cache_size; i < cache.size(); ++i)
+            rescore(cache[i], -1);
+
+        cache.resize(std::min<size_t>(cache.size(), cache_size));
+
+        for(uint32_t i = 0; i < cache.size(); ++i)
+            rescore(cache[i], static_cast<int32_t>(i));
+
+        // the best triangle touching the cache is drawn next
+        best_tri         = no_index;
+        float best_score = -1.0f;
+        for(auto const v : cache)
+        {
+            for(uint32_t i = adj_offset[v]; i < adj_offset[v] + active_tris[v]; ++i)
+            {
+                if(tri_score[adj[i]] > best_score)
+                {
+                    best_score = tri_score[adj[i]];
+                    best_tri   = adj[i];
+                }
+            }
+        }
+    }
+
+    indexes.swap(out);
+}
+
+void OptimizeVertexFetch(Mesh & msh)
+{
+    auto const num_vertices = static_cast<uint32_t>(msh.pos.size());
+
+    std::vector<uint32_t> old_to_new(num_vertices, no_index);
+    std::vector<uint32_t> new_to_old;
+    new_to_old.reserve(num_vertices);
+
+    auto const renumber = [&](std::vector<uint32_t> & indexes) {
+        for(auto & index : indexes)
+        {
+            if(old_to_new[index] == no_index)
+            {
+                old_to_new[index] = static_cast<uint32_t>(new_to_old.size());
+                new_to_old.push_back(index);
+            }
+
+            index = old_to_new[index];
+        }
+    };
+
+    for(auto lod = msh.lods.rbegin(); lod != msh.lods.rend(); ++lod)
+    {
+        renumber(lod->indexes);
+        lod->num_vertices = static_cast<uint32_t>(new_to_old.size());
+    }
+    renumber(msh.indexes);
+
+    for(uint32_t v = 0; v < num_vertices; ++v)
+    {
+        if(old_to_new[v] == no_index)
+            new_to_old.push_back(v);
+    }
+
+    Permute(msh.pos, new_to_old);
+    Permute(msh.normal, new_to_old);
+    Permute(msh.tangent, new_to_old);
+    Permute(msh.bitangent, new_to_old);
+    Permute(msh.tex_coords, new_to_old);
+
+    // weight ranges are rebuilt so the weights stay in vertex order too
+    if(msh.weight_indxs.size() == num_vertices)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> weight_indxs;
+        std::vector<Mesh::Weight>                  weights;
+
+        weight_indxs.reserve(num_vertices);
+        weights.reserve(msh.weights.size());
+        for(auto const old_index : new_to_old)
+        {
+            auto const first = static_cast<uint32_t>(weights.size());
+            auto const range = msh.weight_indxs[old_index];
+
+            weights.insert(weights.end(), msh.weights.begin() + range.first,
+                           msh.weights.begin() + range.second);
+            weight_indxs.push_back({first, static_cast<uint32_t>(weights.size())});
+        }
+
+        msh.weight_indxs.swap(weight_indxs);
+        msh.weights.swap(weights);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef MESHOPT_H
+#define MESHOPT_H
+
+#include <cstdint>
+#include <vector>
+
+struct Mesh;
+
+// Import time mesh optimization, runs once per loaded mesh:
+//      lods by edge collapse (Garland-Heckbert quadric error metrics), then
+//      triangle order for the post-transform vertex cache of every level
+//      (Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"), then vertex
+//      order for fetch locality, all per vertex data and weights are remapped
+void OptimizeMesh(Mesh & msh);
+
+// half edge collapses keep the surviving vertices untouched, so the skin
+// weights of a level are a subset of the full mesh weights
+void GenerateLods(Mesh & msh);
+void OptimizeVertexCache(std::vector<uint32_t> & indexes, uint32_t num_vertices);
+// renumbers vertices in order of first use from the coarsest lod to the full
+// mesh, every lod then uses a prefix of the vertices, unused ones go last
+void OptimizeVertexFetch(Mesh & msh);
+
+#endif   // MESHOPT_H
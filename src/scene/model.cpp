@@ -1,69 +1,101 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 
+#include "camera.h"
 #include "scenecmp.h"
 #include "material.h"
+#include "meshopt.h"
 #include "model.h"
+#include "src/utils/allocstats.h"
 
 void JointSystem::update(double time)
 {
+    ++m_frame;
+
     for(auto ent : m_reg.view<ModelComponent, CurrentAnimSequence>())
     {
         auto const & seq = m_reg.get<CurrentAnimSequence>(ent);
         auto const & mdl = m_reg.get<ModelComponent>(ent);
 
         auto const & cur_animation = mdl.animations[seq.id];
+        auto const   sample        = getFrameSample(time, cur_animation);
+
+        // bounds are cheap and keep culling right for hidden models
+        updateMdlBbox(ent, getCurrentBbox(sample, cur_animation));
 
-        auto frame = getCurrentFrame(time, cur_animation);
-        updateModelJoints(ent, frame);
-        updateMdlBbox(ent, frame);
+        uint32_t const tier = std::min(seq.tier, static_cast<uint32_t>(tier_intervals.size()) - 1);
+        if(!seq.visible || (m_frame + static_cast<uint32_t>(ent)) % tier_intervals[tier] != 0)
+            continue;
+
+        updateModelJoints(ent, getCurrentFrame(sample, cur_animation, tier + 1 < tier_intervals.size()));
     }
 }
 
-JointsTransform JointSystem::getCurrentFrame(double time, AnimSequence const & frame_seq) const
+JointSystem::FrameSample JointSystem::getFrameSample(double time, AnimSequence const & frame_seq) const
 {
-    float           frame_delta = 0.0f;
-    uint32_t        last_frame  = 0;
-    uint32_t        next_frame  = 0;
-    JointsTransform cur_frame;
+    FrameSample sample;
 
     double control_time = frame_seq.controller.getControlTime(time);
-    last_frame          = static_cast<uint32_t>(glm::floor(control_time * frame_seq.frame_rate));
-    next_frame          = last_frame + 1;
-    if(next_frame == frame_seq.frames.size())
-        next_frame = 0;
-
-    frame_delta    = static_cast<float>(control_time * frame_seq.frame_rate - last_frame);
-    cur_frame.bbox = {glm::mix(frame_seq.frames[last_frame].bbox.min(),
-                               frame_seq.frames[next_frame].bbox.min(), frame_delta),
-                      glm::mix(frame_seq.frames[last_frame].bbox.max(),
-                               frame_seq.frames[next_frame].bbox.max(), frame_delta)};
-    for(uint32_t i = 0; i < frame_seq.frames[0].rot.size(); i++)
+    sample.last         = static_cast<uint32_t>(glm::floor(control_time * frame_seq.frame_rate));
+    sample.next         = sample.last + 1;
+    if(sample.next == frame_seq.frames.size())
+        sample.next = 0;
+
+    sample.delta = static_cast<float>(control_time * frame_seq.frame_rate - sample.last);
+
+    return sample;
+}
+
+evnt::AABB JointSystem::getCurrentBbox(FrameSample const & sample, AnimSequence const & frame_seq) const
+{
+    auto const & last = frame_seq.frames[sample.last].bbox;
+    auto const & next = frame_seq.frames[sample.next].bbox;
+
+    return {glm::mix(last.min(), next.min(), sample.delta), glm::mix(last.max(), next.max(), sample.delta)};
+}
+
+JointSystem::Pose JointSystem::getCurrentFrame(FrameSample const & sample, AnimSequence const & frame_seq,
+                                               bool blend) const
+{
+    Pose pose;
+
+    if(!blend)
+    {
+        auto const & key = frame_seq.frames[sample.delta < 0.5f ? sample.last : sample.next];
+
+        pose.rot.assign(key.rot.begin(), key.rot.end());
+        pose.trans.assign(key.trans.begin(), key.trans.end());
+
+        return pose;
+    }
+
+    auto const & last = frame_seq.frames[sample.last];
+    auto const & next = frame_seq.frames[sample.next];
+
+    pose.rot.reserve(last.rot.size());
+    pose.trans.reserve(last.trans.size());
+    for(uint32_t i = 0; i < last.rot.size(); i++)
     {
-        cur_frame.rot.push_back(glm::normalize(glm::slerp(frame_seq.frames[last_frame].rot[i],
-                                                          frame_seq.frames[next_frame].rot[i], frame_delta)));
-        cur_frame.trans.push_back(glm::mix(frame_seq.frames[last_frame].trans[i],
-                                           frame_seq.frames[next_frame].trans[i], frame_delta));
+        pose.rot.push_back(glm::normalize(glm::slerp(last.rot[i], next.rot[i], sample.delta)));
+        pose.trans.push_back(glm::mix(last.trans[i], next.trans[i], sample.delta));
     }
 
-    return cur_frame;
+    return pose;
 }
 
-void JointSystem::updateModelJoints(Entity ent, JointsTransform const & frame) const
+void JointSystem::updateModelJoints(Entity ent, Pose const & pose) const
 {
     auto const & mdl = m_reg.get<ModelComponent>(ent);
 
     for(uint32_t i = 0; i < mdl.joint_id_to_entity.size(); ++i)
     {
         auto   joint_ent = mdl.joint_id_to_entity[i];
-        auto & joint_pos = m_reg.get<SceneComponent>(joint_ent);
-
-        glm::mat4 mt = glm::mat4_cast(frame.rot[i]);
-        mt           = glm::column(mt, 3, glm::vec4(frame.trans[i], 1.0f));
+        auto & joint_pos = m_reg.get<LocalTransformComponent>(joint_ent);
 
         // replace relative matrix with new value
-        joint_pos.rel = mt;
+        joint_pos.rel = evnt::Affine(glm::mat3_cast(pose.rot[i]), pose.trans[i]);
     }
 
     // update abs matrices in scene graph from root bone in scene_sys.update()
@@ -73,13 +105,13 @@ void JointSystem::updateModelJoints(Entity ent, JointsTransform const & frame) c
     m_reg.add_component<Event::Scene::TransformComponent>(mdl.joint_id_to_entity[0], transform);
 }
 
-void JointSystem::updateMdlBbox(Entity ent, JointsTransform const & frame) const
+void JointSystem::updateMdlBbox(Entity ent, evnt::AABB const & bbox) const
 {
-    auto & pos = m_reg.get<SceneComponent>(ent);
+    auto & bnd = m_reg.get<BoundsComponent>(ent);
     auto & mdl = m_reg.get<ModelComponent>(ent);
 
-    pos.initial_bbox = frame.bbox;
-    mdl.base_bbox    = frame.bbox;
+    bnd.initial_bbox = bbox;
+    mdl.base_bbox    = bbox;
 
     m_reg.add_component<Event::Scene::IsBboxUpdated>(ent);
 }
@@ -90,6 +122,7 @@ bool ModelSystem::LoadMesh(std::string const & fname, ModelComponent & out_mdl,
     if(!out_mdl.meshes.empty())
         return false;   // out model not empty
 
+    MemTagScope   tag(MemTag::Mesh);
     std::ifstream in(fname, std::ios::in);
     if(!in)
         return false;
@@ -225,9 +258,7 @@ bool ModelSystem::LoadMesh(std::string const & fname, ModelComponent & out_mdl,
             auto rot   = glm::quat(qtw, qtx, qty, qtz);
             auto trans = glm::vec3(tr_x, tr_y, tr_z);
 
-            glm::mat4 mt   = glm::mat4_cast(rot);
-            mt             = glm::column(mt, 3, glm::vec4(trans, 1.0f));
-            joint.inv_bind = mt;
+            joint.inv_bind = evnt::Affine(glm::mat3_cast(rot), trans);
 
             joints.push_back(std::move(joint));
         }
@@ -249,11 +280,18 @@ bool ModelSystem::LoadMesh(std::string const & fname, ModelComponent & out_mdl,
             return false;
     }
 
+    for(auto & msh : out_mdl.meshes)
+    {
+        OptimizeMesh(msh);
+        out_mdl.num_lods = std::max(out_mdl.num_lods, static_cast<uint32_t>(msh.lods.size()) + 1);
+    }
+
     return true;
 }
 
 bool ModelSystem::LoadAnim(std::string const & fname, ModelComponent & out_mdl)
 {
+    MemTagScope   tag(MemTag::Animation);
     std::ifstream in(fname, std::ios::in);
     if(!in)
         return false;
@@ -338,13 +376,24 @@ bool ModelSystem::LoadAnim(std::string const & fname, ModelComponent & out_mdl)
     return true;
 }
 
+ModelSystem::ModelSystem(Registry & reg) : ISystem(reg)
+{
+    m_posed_joints.connect<WorldTransformComponent, JointComponent>(m_reg);
+}
+
 void ModelSystem::update(double time)
 {
     for(auto ent : m_reg.view<ModelComponent, Event::Model::LoadModel>())
     {
         auto & lm_event = m_reg.get<Event::Model::LoadModel>(ent);
 
-        loadModel(ent, *lm_event.scene, lm_event.mesh_name, lm_event.anim_name, lm_event.material_name);
+        ModelData data;
+        if(lm_event.data)
+            data = std::move(*lm_event.data);
+        else
+            ReadModel(lm_event.mesh_name, lm_event.anim_name, lm_event.material_name, data);
+
+        loadModel(ent, *lm_event.scene, std::move(data));
 
         // mark for render
         m_reg.add_component<Event::Model::UploadBuffer>(ent);
@@ -352,48 +401,43 @@ void ModelSystem::update(double time)
     }
     m_reg.reset<Event::Model::LoadModel>();
 
+    for(auto ent : m_reg.view<ModelComponent, Event::Model::ReloadData>())
+    {
+        reloadModel(ent);
+    }
+    m_reg.reset<Event::Model::ReloadData>();
+
     // update positions for animated meshes
     for(auto ent : m_reg.view<ModelComponent, CurrentAnimSequence>())
     {
         auto &       geom = m_reg.get<ModelComponent>(ent);
-        auto const & scn  = m_reg.get<SceneComponent>(ent);
-
-        glm::mat4 inverted_model = glm::inverse(scn.abs);
-
-        for(auto & msh : geom.meshes)
+        auto const & scn  = m_reg.get<WorldTransformComponent>(ent);
+
+        // joints skipped by the animation lod keep the last skinned vertices
+        bool const posed = std::any_of(geom.joint_id_to_entity.begin(), geom.joint_id_to_entity.end(),
+                                       [this](Entity joint_ent) {
+                                           return m_posed_joints.contains(joint_ent);
+                                       });
+        if(!posed && !geom.skin_mats.empty())
+            continue;
+
+        evnt::Affine inverted_model = scn.abs.inverse();
+
+        // skin matrices once per joint instead of once per vertex weight, the
+        // vertices are skinned by the renderer into the upload buffer
+        geom.skin_mats.clear();
+        for(auto joint_ent : geom.joint_id_to_entity)
         {
-            msh.frame_pos.resize(0);
-            msh.frame_normal.resize(0);
-            msh.frame_tangent.resize(0);
-            msh.frame_bitangent.resize(0);
+            auto const & joint_scn = m_reg.get<WorldTransformComponent>(joint_ent);
+            auto const & jont_cmp  = m_reg.get<JointComponent>(joint_ent);
 
-            for(uint32_t n = 0; n < msh.pos.size(); ++n)
-            {
-                glm::mat4 vert_mat(0.0f);
-                for(uint32_t j = msh.weight_indxs[n].first; j < msh.weight_indxs[n].second; ++j)
-                {
-                    auto         joint_ent = geom.joint_id_to_entity[msh.weights[j].joint_index];
-                    auto const & joint_scn = m_reg.get<SceneComponent>(joint_ent);
-                    auto const & jont_cmp  = m_reg.get<JointComponent>(joint_ent);
-
-                    vert_mat += inverted_model * joint_scn.abs * jont_cmp.inv_bind * msh.weights[j].w;
-                }
-                glm::mat3 norm_mat = glm::mat3(vert_mat);
-
-                glm::vec4 n_pos   = vert_mat * glm::vec4(msh.pos[n], 1.0f);
-                glm::vec3 n_norm  = norm_mat * msh.normal[n];
-                glm::vec3 n_tang  = norm_mat * msh.tangent[n];
-                glm::vec3 n_bitan = norm_mat * msh.bitangent[n];
-
-                msh.frame_pos.push_back(glm::vec3(n_pos));
-                msh.frame_normal.push_back(n_norm);
-                msh.frame_tangent.push_back(n_tang);
-                msh.frame_bitangent.push_back(n_bitan);
-            }
+            geom.skin_mats.push_back(inverted_model * joint_scn.abs * jont_cmp.inv_bind);
         }
+
         // event for render for update buffers data
         m_reg.add_component<Event::Model::VertexDataChanged>(ent);
     }
+    m_posed_joints.clear();
 
     for(auto ent : m_reg.view<ModelComponent, Event::Model::DestroyModel>())
     {
@@ -402,57 +446,219 @@ void ModelSystem::update(double time)
     m_reg.reset<Event::Model::DestroyModel>();
 }
 
+void ModelSystem::SkinMesh(Mesh const & msh, std::vector<evnt::Affine> const & skin_mats,
+                           SkinnedStream const & out, uint32_t num_vertices)
+{
+    for(uint32_t n = 0; n < num_vertices; ++n)
+    {
+        evnt::Affine vert_mat(glm::mat3(0.0f), glm::vec3(0.0f));
+        for(uint32_t j = msh.weight_indxs[n].first; j < msh.weight_indxs[n].second; ++j)
+        {
+            vert_mat += skin_mats[msh.weights[j].joint_index] * msh.weights[j].w;
+        }
+        glm::mat3 const & norm_mat = vert_mat.basis();
+        size_t const      offset   = n * out.stride;
+
+        glm::vec3 const n_pos   = vert_mat.transformPoint(msh.pos[n]);
+        glm::vec3 const n_norm  = norm_mat * msh.normal[n];
+        glm::vec3 const n_tang  = norm_mat * msh.tangent[n];
+        glm::vec3 const n_bitan = norm_mat * msh.bitangent[n];
+
+        // the destination may be write combined memory, write every byte once
+        std::memcpy(out.pos + offset, &n_pos, sizeof(n_pos));
+        std::memcpy(out.normal + offset, &n_norm, sizeof(n_norm));
+        std::memcpy(out.uv + offset, &msh.tex_coords[n], sizeof(msh.tex_coords[n]));
+        std::memcpy(out.tangent + offset, &n_tang, sizeof(n_tang));
+        std::memcpy(out.bitangent + offset, &n_bitan, sizeof(n_bitan));
+    }
+}
+
+uint32_t ModelSystem::GetLodVertices(Mesh const & msh, uint32_t lod)
+{
+    // meshes with fewer levels keep drawing their coarsest one
+    if(lod == 0 || msh.lods.empty())
+        return static_cast<uint32_t>(msh.pos.size());
+
+    return msh.lods[std::min(lod, static_cast<uint32_t>(msh.lods.size())) - 1].num_vertices;
+}
+
+void ModelSystem::ReleaseMeshData(ModelComponent & mdl)
+{
+    if(mdl.mesh_name.empty())
+        return;
+
+    // the bbox and the lod count stay for culling and lod selection
+    for(auto & msh : mdl.meshes)
+    {
+        Mesh released;
+        released.short_indices = msh.short_indices;
+        released.bbox          = msh.bbox;
+
+        msh = std::move(released);
+    }
+
+    mdl.cpu_resident = false;
+}
+
+void ModelSystem::selectLods(CameraComponent const & cam, std::vector<Entity> const & models) const
+{
+    // bound sphere height on the screen relative to the viewport height
+    // where the next level starts
+    static constexpr float lod_screen_sizes[]  = {0.5f, 0.25f, 0.125f};
+    static constexpr float anim_screen_sizes[] = {0.2f, 0.05f};
+
+    float const tan_half_fov = cam.m_frust_near > 0.0f ? cam.m_frust_top / cam.m_frust_near : 1.0f;
+
+    // culled models are not posed until they are visible again
+    for(auto ent : m_reg.view<ModelComponent, CurrentAnimSequence>())
+        m_reg.get<CurrentAnimSequence>(ent).visible = false;
+
+    for(auto ent : models)
+    {
+        auto &       mdl = m_reg.get<ModelComponent>(ent);
+        auto const & bnd = m_reg.get<BoundsComponent>(ent);
+        auto * const seq =
+            m_reg.has<CurrentAnimSequence>(ent) ? &m_reg.get<CurrentAnimSequence>(ent) : nullptr;
+
+        mdl.lod = 0;
+        if(seq)
+        {
+            seq->visible = true;
+            seq->tier    = 0;
+        }
+        if((mdl.num_lods < 2 && !seq) || !bnd.transformed_bbox)
+            continue;
+
+        auto const &    bbox   = *bnd.transformed_bbox;
+        glm::vec3 const center = (bbox.min() + bbox.max()) * 0.5f;
+        float const     radius = glm::length(bbox.max() - bbox.min()) * 0.5f;
+        float const     depth  = -(cam.m_view_mat * glm::vec4(center, 1.0f)).z;
+
+        // the camera inside the bounds keeps the full mesh
+        if(!cam.m_orthographic && depth <= radius)
+            continue;
+
+        float const size = cam.m_orthographic ? radius / cam.m_frust_top : radius / (depth * tan_half_fov);
+        for(auto const threshold : lod_screen_sizes)
+        {
+            if(size >= threshold || mdl.lod + 1 >= mdl.num_lods)
+                break;
+
+            mdl.lod++;
+        }
+
+        if(!seq)
+            continue;
+
+        for(auto const threshold : anim_screen_sizes)
+        {
+            if(size >= threshold || seq->tier + 1 >= JointSystem::tier_intervals.size())
+                break;
+
+            seq->tier++;
+        }
+    }
+}
+
+uint64_t ModelSystem::GetMeshBytes(ModelComponent const & mdl)
+{
+    uint64_t mesh_bytes = VectorBytes(mdl.meshes) + mdl.mesh_name.capacity();
+    for(auto const & msh : mdl.meshes)
+    {
+        mesh_bytes += VectorBytes(msh.pos) + VectorBytes(msh.normal) + VectorBytes(msh.tangent)
+                      + VectorBytes(msh.bitangent) + VectorBytes(msh.weight_indxs) + VectorBytes(msh.weights)
+                      + VectorBytes(msh.tex_coords) + VectorBytes(msh.indexes) + VectorBytes(msh.lods);
+        for(auto const & lod : msh.lods)
+            mesh_bytes += VectorBytes(lod.indexes);
+    }
+
+    return mesh_bytes;
+}
+
+uint64_t ModelSystem::GetAnimBytes(ModelComponent const & mdl)
+{
+    uint64_t anim_bytes =
+        VectorBytes(mdl.animations) + VectorBytes(mdl.joint_id_to_entity) + VectorBytes(mdl.skin_mats);
+    for(auto const & seq : mdl.animations)
+    {
+        anim_bytes += VectorBytes(seq.frames);
+        for(auto const & frame : seq.frames)
+            anim_bytes += VectorBytes(frame.rot) + VectorBytes(frame.trans);
+    }
+
+    return anim_bytes;
+}
+
+void ModelSystem::accountMemory(MemoryReport & report) const
+{
+    for(auto ent : m_reg.view<ModelComponent>())
+    {
+        auto const & mdl = m_reg.get<ModelComponent>(ent);
+
+        report.add(MemTag::Mesh, GetMeshBytes(mdl));
+        report.add(MemTag::Animation, GetAnimBytes(mdl));
+    }
+
+    for(auto ent : m_reg.view<MaterialComponent>())
+        report.add(MemTag::Image, MaterialSystem::GetMemoryUsage(m_reg.get<MaterialComponent>(ent)));
+}
+
 void ModelSystem::postUpdate()
 {
     m_reg.reset<Event::Model::VertexDataChanged>();
 }
 
-// mdl_cmp[parent]
-//   jnt_cmp_root[child]
-void ModelSystem::loadModel(Entity model_ent, SceneSystem & scene_sys, std::string const & fname,
-                            std::string const & anim_fname, std::string const & mat_fname) const
+void ModelSystem::ReadModel(std::string const & fname, std::string const & anim_fname,
+                            std::string const & mat_fname, ModelData & out)
 {
-    auto & mdl = m_reg.get<ModelComponent>(model_ent);
-    auto & mat = m_reg.get<MaterialComponent>(model_ent);
-    auto & scn = m_reg.get<SceneComponent>(model_ent);
-
     // Load mesh
-    std::vector<ParsedJoint> joints;
-    if(!ModelSystem::LoadMesh(fname, mdl, joints))
+    if(!ModelSystem::LoadMesh(fname, out.mdl, out.joints))
         throw std::runtime_error{"Failed to load mesh"};
+    out.mdl.mesh_name = fname;
+    out.mdl.anim_name = anim_fname;
 
     // Load the textures
-    if(!MaterialSystem::LoadTGA(mat, mat_fname, {}))
+    if(!MaterialSystem::LoadTGA(out.mat, mat_fname, {}))
         throw std::runtime_error{"Failed to load texture"};
 
+    // if we have skeleton and animation
+    out.animated = !out.joints.empty() && ModelSystem::LoadAnim(anim_fname, out.mdl);
+}
+
+// mdl_cmp[parent]
+//   jnt_cmp_root[child]
+void ModelSystem::loadModel(Entity model_ent, SceneSystem & scene_sys, ModelData data) const
+{
+    auto & mdl = m_reg.get<ModelComponent>(model_ent);
+    auto & mat = m_reg.get<MaterialComponent>(model_ent);
+    auto & bnd = m_reg.get<BoundsComponent>(model_ent);
+
+    mdl = std::move(data.mdl);
+    mat = std::move(data.mat);
+
     // set AABB
-    scn.initial_bbox = mdl.base_bbox;
+    bnd.initial_bbox = mdl.base_bbox;
 
-    // if we have skeleton
-    if(!joints.empty())
+    if(data.animated)
     {
-        // and animation
-        if(ModelSystem::LoadAnim(anim_fname, mdl))
+        // add joints to the scene
+        for(auto & jnt : data.joints)
         {
-            // add joints to the scene
-            for(auto & jnt : joints)
-            {
-                auto   joint_ent = EntityBuilder::BuildEntity(m_reg, joint_flags);
-                auto & jnt_cmp   = m_reg.get<JointComponent>(joint_ent);
+            auto   joint_ent = EntityBuilder::BuildEntity(m_reg, joint_flags);
+            auto & jnt_cmp   = m_reg.get<JointComponent>(joint_ent);
 
-                mdl.joint_id_to_entity[jnt.index] = joint_ent;
-                Entity parent_ent                 = model_ent;
-                if(jnt.parent != -1)
-                    parent_ent = mdl.joint_id_to_entity[jnt.parent];
+            mdl.joint_id_to_entity[jnt.index] = joint_ent;
+            Entity parent_ent                 = model_ent;
+            if(jnt.parent != -1)
+                parent_ent = mdl.joint_id_to_entity[jnt.parent];
 
-                jnt_cmp.index    = jnt.index;
-                jnt_cmp.name     = jnt.name;
-                jnt_cmp.inv_bind = jnt.inv_bind;
+            jnt_cmp.index    = jnt.index;
+            jnt_cmp.name     = jnt.name;
+            jnt_cmp.inv_bind = jnt.inv_bind;
 
-                scene_sys.connectNode(joint_ent, parent_ent);
-            }
-            m_reg.assign<CurrentAnimSequence>(model_ent);
+            scene_sys.connectNode(joint_ent, parent_ent);
         }
+        m_reg.assign<CurrentAnimSequence>(model_ent);
     }
 }
 
@@ -462,6 +668,39 @@ void ModelSystem::deleteModel(Entity model_id) const
     m_reg.assign<Event::Model::UnloadBuffer>(model_id);
 
     m_reg.assign<Event::Deleter::DeleteEntity>(model_id);
+    // the skeleton goes with the model, joints are only created with an animation
+    if(m_reg.has<CurrentAnimSequence>(model_id))
+    {
+        for(auto joint_ent : m_reg.get<ModelComponent>(model_id).joint_id_to_entity)
+            m_reg.assign<Event::Deleter::DeleteEntity>(joint_ent);
+    }
+}
+
+void ModelSystem::reloadModel(Entity model_id) const
+{
+    auto & mdl = m_reg.get<ModelComponent>(model_id);
+
+    if(!mdl.cpu_resident)
+    {
+        // the import is deterministic, the lods and the vertex order match
+        ModelComponent           loaded;
+        std::vector<ParsedJoint> joints;
+        if(!ModelSystem::LoadMesh(mdl.mesh_name, loaded, joints))
+            throw std::runtime_error{"Failed to reload mesh"};
+
+        mdl.meshes       = std::move(loaded.meshes);
+        mdl.cpu_resident = true;
+    }
+
+    if(m_reg.has<MaterialComponent>(model_id))
+    {
+        if(!MaterialSystem::ReloadImages(m_reg.get<MaterialComponent>(model_id)))
+            throw std::runtime_error{"Failed to reload texture"};
+    }
+
+    // mark for render
+    m_reg.add_component<Event::Model::UploadBuffer>(model_id);
+    m_reg.add_component<Event::Model::UploadTexture>(model_id);
 }
 
 std::optional<Entity> ModelSystem::getJointIdFromName(Entity model_id, std::string const & bone_name)
@@ -1,16 +1,24 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <array>
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <memory>
 #include <optional>
 
 #include "AABB.h"
+#include "affine.h"
+#include "material.h"
 #include "sceneentitybuilder.h"
 #include "src/scene/scenecmp.h"
 #include "src/utils/controller.h"
+#include "src/utils/framearena.h"
+
+struct CameraComponent;
+struct MemoryReport;
 
 struct Mesh
 {
@@ -20,31 +28,48 @@ struct Mesh
         float    w           = 0.0f;
     };
 
-    // dynamic data initial
+    // coarser levels use a prefix of the vertices, a skinned lod only needs
+    // num_vertices skinned
+    struct Lod
+    {
+        std::vector<uint32_t> indexes;
+        uint32_t              num_vertices = 0;
+    };
+
+    // dynamic data initial, skinned frames are written straight to the GPU
     std::vector<glm::vec3> pos;
     std::vector<glm::vec3> normal;
     std::vector<glm::vec3> tangent;
     std::vector<glm::vec3> bitangent;
-    // dynamic data transformed
-    std::vector<glm::vec3> frame_pos;
-    std::vector<glm::vec3> frame_normal;
-    std::vector<glm::vec3> frame_tangent;
-    std::vector<glm::vec3> frame_bitangent;
     // static data
     std::vector<std::pair<uint32_t, uint32_t>>
                            weight_indxs;   // start and end indicies for vertex in weights_vec
     std::vector<Weight>    weights;
     std::vector<glm::vec2> tex_coords;
-    std::vector<uint32_t>  indexes;
+    std::vector<uint32_t>  indexes;   // vertex cache order, see OptimizeMesh
+    bool                   short_indices = false;   // every index fits in 16 bits
+    std::vector<Lod>       lods;                    // levels 1..n, see GenerateLods
 
     evnt::AABB bbox;
 };
 
+// Destination of ModelSystem::SkinMesh, every pointer is advanced by stride
+// bytes per vertex so the output can be an interleaved (mapped) buffer
+struct SkinnedStream
+{
+    uint8_t * pos       = nullptr;
+    uint8_t * normal    = nullptr;
+    uint8_t * uv        = nullptr;
+    uint8_t * tangent   = nullptr;
+    uint8_t * bitangent = nullptr;
+    size_t    stride    = 0;
+};
+
 struct JointComponent
 {
-    int32_t     index = 0;   // -1 for root
-    std::string name;
-    glm::mat4   inv_bind;
+    int32_t      index = 0;   // -1 for root
+    std::string  name;
+    evnt::Affine inv_bind;
 };
 
 struct JointsTransform
@@ -65,14 +90,19 @@ struct AnimSequence
 struct CurrentAnimSequence
 {
     uint32_t id = 0;
+    // animation lod from the culling results of the last frame, see
+    // ModelSystem::selectLods, hidden models keep their pose. A bool, the
+    // width keeps padding out of the state records
+    uint32_t visible = 1;
+    uint32_t tier    = 0;
 };
 
 struct ParsedJoint
 {
-    int32_t     index  = 0;
-    int32_t     parent = 0;
-    std::string name;
-    glm::mat4   inv_bind;
+    int32_t      index  = 0;
+    int32_t      parent = 0;
+    std::string  name;
+    evnt::Affine inv_bind;
 };
 
 // Model consist of next sequence of components:
@@ -84,11 +114,29 @@ struct ModelComponent
     std::vector<Mesh>         meshes;
     std::vector<Entity>       joint_id_to_entity;   // skel
     std::vector<AnimSequence> animations;
+    std::vector<evnt::Affine> skin_mats;   // per joint, bind pose to the current frame in model space
     std::string               material_name;
+    std::string               mesh_name;   // source file, models of the same mesh share GPU buffers
+    std::string               anim_name;
+    uint32_t                  num_lods = 1;   // level 0 is the full mesh
+    uint32_t                  lod      = 0;   // selected by ModelSystem::selectLods
+    // false once the mesh arrays of a static model were released after the
+    // upload, ModelSystem::reloadModel reads them again from mesh_name
+    bool cpu_resident = true;
 
     evnt::AABB base_bbox;
 };
 
+// files of a model read by ModelSystem::ReadModel, turned into entities by
+// ModelSystem::loadModel on the update thread
+struct ModelData
+{
+    ModelComponent           mdl;
+    MaterialComponent        mat = MaterialSystem::GetDefaultMaterialComponent();
+    std::vector<ParsedJoint> joints;
+    bool                     animated = false;   // skeleton with a loaded animation
+};
+
 namespace Event
 {
 namespace Model
@@ -102,6 +150,10 @@ namespace Model
     struct UploadTexture
     {};
 
+    // the GL context was lost, released data is read again and uploaded
+    struct ReloadData
+    {};
+
     struct UnloadBuffer
     {};
 
@@ -115,14 +167,17 @@ namespace Model
         std::string anim_name;
         std::string material_name;
         glm::mat4   rel_transform;
+        // files already read off the update thread, see WorldStreamer
+        std::shared_ptr<ModelData> data;
     };
 
     struct LoadModel
     {
-        SceneSystem * scene = nullptr;
-        std::string   mesh_name;
-        std::string   anim_name;
-        std::string   material_name;
+        SceneSystem *              scene = nullptr;
+        std::string                mesh_name;
+        std::string                anim_name;
+        std::string                material_name;
+        std::shared_ptr<ModelData> data;
     };
 
     struct DestroyModel
@@ -136,15 +191,37 @@ namespace Model
 class JointSystem : public ISystem
 {
 public:
+    // poses of a tier are sampled every n-th frame, staggered over the
+    // models, the last tier snaps to the nearest key instead of blending
+    static constexpr std::array<uint32_t, 3> tier_intervals = {1, 2, 4};
+
     JointSystem(Registry & reg) : ISystem(reg) {}
 
     void        update(double time = 1.0) override;
     std::string getName() const override { return "JointSystem"; }
 
 private:
-    JointsTransform getCurrentFrame(double time, AnimSequence const & seq) const;
-    void            updateModelJoints(Entity mdl, JointsTransform const & frame) const;
-    void            updateMdlBbox(Entity mdl, JointsTransform const & frame) const;
+    struct FrameSample
+    {
+        uint32_t last  = 0;
+        uint32_t next  = 0;
+        float    delta = 0.0f;
+    };
+
+    // joint transforms of the current frame in the frame arena
+    struct Pose
+    {
+        FrameVector<glm::quat> rot;
+        FrameVector<glm::vec3> trans;
+    };
+
+    uint32_t m_frame = 0;
+
+    FrameSample getFrameSample(double time, AnimSequence const & seq) const;
+    evnt::AABB  getCurrentBbox(FrameSample const & sample, AnimSequence const & seq) const;
+    Pose        getCurrentFrame(FrameSample const & sample, AnimSequence const & seq, bool blend) const;
+    void        updateModelJoints(Entity mdl, Pose const & pose) const;
+    void        updateMdlBbox(Entity mdl, evnt::AABB const & bbox) const;
 };
 
 class ModelSystem : public ISystem
@@ -154,18 +231,37 @@ public:
     static bool           LoadMesh(std::string const & fname, ModelComponent & out_mdl,
                                    std::vector<ParsedJoint> & joints);
     static bool           LoadAnim(std::string const & fname, ModelComponent & out_mdl);
+    static void           SkinMesh(Mesh const & msh, std::vector<evnt::Affine> const & skin_mats,
+                                   SkinnedStream const & out, uint32_t num_vertices);
+    static uint32_t       GetLodVertices(Mesh const & msh, uint32_t lod);
+    // reads the mesh, animation and texture files, touches no shared state
+    // and may run on any thread
+    static void           ReadModel(std::string const & fname, std::string const & anim_fname,
+                                    std::string const & mat_fname, ModelData & out);
+    static uint64_t       GetMeshBytes(ModelComponent const & mdl);
+    static uint64_t       GetAnimBytes(ModelComponent const & mdl);
+    // frees the mesh arrays of a model that can be read again from its file
+    static void           ReleaseMeshData(ModelComponent & mdl);
 
-    ModelSystem(Registry & reg) : ISystem(reg) {}
+    ModelSystem(Registry & reg);
     // bool        init() override { return true; }
     void        update(double time = 1.0) override;
     void        postUpdate() override;   // clear tag structures
     std::string getName() const override { return "ModelSystem"; }
 
-    void loadModel(Entity model_ent, SceneSystem & scene_sys, std::string const & fname,
-                   std::string const & anim_fname, std::string const & mat_fname) const;
+    void loadModel(Entity model_ent, SceneSystem & scene_sys, ModelData data) const;
     void deleteModel(Entity model_id) const;
+    void reloadModel(Entity model_id) const;
+    // picks the mesh lod and the animation tier of every visible model from
+    // its projected size
+    void selectLods(CameraComponent const & cam, std::vector<Entity> const & models) const;
+    // adds the CPU side of the models and their materials
+    void accountMemory(MemoryReport & report) const;
 
     std::optional<Entity> getJointIdFromName(Entity model_id, std::string const & bone_name);
+
+private:
+    Observer m_posed_joints;   // joints moved since the last update
 };
 
 #endif
@@ -1,87 +1,84 @@
 #include "scenecmp.h"
 #include "model.h"
 #include "src/scene/light.h"
+#include "src/utils/threadpool.h"
 #include <stdexcept>
+#include <algorithm>
 
-SceneComponent SceneSystem::GetDefaultSceneComponent()
+namespace
 {
-    SceneComponent node;
+// smaller scenes are not worth the thread synchronization
+constexpr uint32_t parallel_min_nodes = 1024;
+}   // namespace
+
+HierarchyComponent SceneSystem::GetDefaultHierarchyComponent()
+{
+    HierarchyComponent node;
     // set defaults
-    node.abs       = glm::mat4(1.0f);
-    node.rel       = glm::mat4(1.0f);
-    node.entity_id = null_entity_id;
-    node.parent    = null_entity_id;
+    node.parent       = null_entity_id;
+    node.first_child  = null_entity_id;
+    node.next_sibling = null_entity_id;
+    node.prev_sibling = null_entity_id;
+    node.flat_index   = null_flat_index;
 
     return node;
 }
 
+SceneSystem::SceneSystem(Registry & reg) : ISystem(reg) {}
+
+SceneSystem::~SceneSystem() = default;
+
 void SceneSystem::update(double time)
 {
-    for(auto ent : m_reg.view<SceneComponent, Event::Model::CreateModel>())
+    for(auto ent : m_reg.view<LocalTransformComponent, Event::Model::CreateModel>())
     {
         auto & cm_event = m_reg.get<Event::Model::CreateModel>(ent);
-        auto & pos      = m_reg.get<SceneComponent>(ent);
+        auto & local    = m_reg.get<LocalTransformComponent>(ent);
 
-        pos.rel = cm_event.rel_transform;
+        local.rel = evnt::Affine(cm_event.rel_transform);
 
         connectNode(ent, cm_event.parent);
 
         Event::Model::LoadModel lm_event{this, std::move(cm_event.mesh_name), std::move(cm_event.anim_name),
-                                         std::move(cm_event.material_name)};
+                                         std::move(cm_event.material_name), std::move(cm_event.data)};
         m_reg.add_component<Event::Model::LoadModel>(ent, std::move(lm_event));
     }
     m_reg.reset<Event::Model::CreateModel>();
 
     // update changed Bboxes from joint sysytem upate call
-    for(auto ent : m_reg.view<SceneComponent, Event::Scene::IsBboxUpdated>())
+    for(auto ent : m_reg.view<BoundsComponent, Event::Scene::IsBboxUpdated>())
     {
-        auto & pos = m_reg.get<SceneComponent>(ent);
-
-        updateBound(ent);
-
-        if(NotNull(pos.parent) && pos.transformed_bbox)
-            propagateBoundToRoot(pos.parent);
+        m_dirty_bounds.push_back(ent);
     }
     m_reg.reset<Event::Scene::IsBboxUpdated>();
 
-    for(auto ent : m_reg.view<SceneComponent, Event::Scene::TransformComponent>())
+    for(auto ent : m_reg.view<LocalTransformComponent, Event::Scene::TransformComponent>())
     {
-        m_transform_updated = true;
-
         auto & trans = m_reg.get<Event::Scene::TransformComponent>(ent);
-        auto & pos   = m_reg.get<SceneComponent>(ent);
+        auto & local = m_reg.get<LocalTransformComponent>(ent);
 
         if(trans.replase_local_matrix)
-            pos.rel = trans.new_mat;
+            local.rel = evnt::Affine(trans.new_mat);
         else
             // old transformation first M_new * M_old * vtx
-            pos.rel = trans.new_mat * pos.rel;
+            local.rel = evnt::Affine(trans.new_mat) * local.rel;
 
-        updateTransform(ent, true);
+        m_dirty_transforms.push_back(ent);
     }
-
     // clear all TransformComponent
-    if(m_transform_updated)
-        m_reg.reset<Event::Scene::TransformComponent>();
+    m_reg.reset<Event::Scene::TransformComponent>();
 
-    for(auto ent : m_reg.view<SceneComponent, Event::Model::DestroyModel>())
+    for(auto ent : m_reg.view<HierarchyComponent, Event::Model::DestroyModel>())
     {
         disconnectNode(ent);
     }
-}
 
-void SceneSystem::postUpdate()
-{
-    if(m_transform_updated)
-    {
-        m_reg.reset<Event::Scene::IsTransformed>();
-        m_transform_updated = false;
-    }
+    propagateChanges();
 }
 
 void SceneSystem::connectNode(Entity node_id, Entity parent)
 {
-    auto & node = m_reg.get<SceneComponent>(node_id);
+    auto & node = m_reg.get<HierarchyComponent>(node_id);
 
     if(parent == null_entity_id)
     {
@@ -91,34 +88,47 @@ void SceneSystem::connectNode(Entity node_id, Entity parent)
         }
 
         m_root = node_id;
-        updateBound(node_id);
     }
     else
     {
-        auto & parent_node = m_reg.get<SceneComponent>(parent);
+        auto & parent_node = m_reg.get<HierarchyComponent>(parent);
         node.parent        = parent;
 
-        parent_node.children.insert(node_id);
-        updateTransform(node_id, true);
-
-        m_transform_updated = true;
+        // push front into the parent's children list
+        node.prev_sibling = null_entity_id;
+        node.next_sibling = parent_node.first_child;
+        if(NotNull(parent_node.first_child))
+            m_reg.get<HierarchyComponent>(parent_node.first_child).prev_sibling = node_id;
+        parent_node.first_child = node_id;
     }
+
+    // abs matrices are recalculated in the next update() pass
+    m_dirty_transforms.push_back(node_id);
+    m_hierarchy_changed = true;
 }
 
 void SceneSystem::disconnectNode(Entity node_id)
 {
-    auto & node = m_reg.get<SceneComponent>(node_id);
+    auto & node = m_reg.get<HierarchyComponent>(node_id);
 
     if(NotNull(node.parent))
     {
-        auto & parent_node = m_reg.get<SceneComponent>(node.parent);
+        auto & parent_node = m_reg.get<HierarchyComponent>(node.parent);
+
+        if(NotNull(node.prev_sibling))
+            m_reg.get<HierarchyComponent>(node.prev_sibling).next_sibling = node.next_sibling;
+        else
+            parent_node.first_child = node.next_sibling;
 
-        parent_node.children.erase(node_id);
-        updateBound(node.parent);
+        if(NotNull(node.next_sibling))
+            m_reg.get<HierarchyComponent>(node.next_sibling).prev_sibling = node.prev_sibling;
+
+        node.next_sibling = node.prev_sibling = null_entity_id;
+
+        m_dirty_bounds.push_back(node.parent);
         node.parent = null_entity_id;
 
-        if(NotNull(parent_node.parent))
-            propagateBoundToRoot(parent_node.parent);
+        m_hierarchy_changed = true;
     }
 }
 
@@ -127,73 +137,241 @@ void SceneSystem::updateQueues(evnt::Frustum const & frustum1, evnt::Frustum con
     m_models_queue.resize(0);
     m_lights_queue.resize(0);
 
-    updateQueuesRec(frustum1, frustum2, m_root);
+    if(m_hierarchy_changed)
+        rebuildFlatHierarchy();
+
+    uint32_t i = 0;
+    while(i < m_flat_nodes.size())
+    {
+        auto const   node_id = m_flat_nodes[i].entity;
+        auto const & node    = m_reg.get<BoundsComponent>(node_id);
+
+        if(node.transformed_bbox && frustum1.cullBox(*node.transformed_bbox))
+        {
+            // skip the whole subtree
+            if(frustum2 == nullptr || frustum2->cullBox(*node.transformed_bbox))
+            {
+                i = m_flat_nodes[i].subtree_end;
+                continue;
+            }
+        }
+
+        // mesh nodes
+        if(m_reg.has<ModelComponent>(node_id) && node.transformed_bbox
+           && !frustum1.cullBox(*node.transformed_bbox))
+        {
+            if(frustum2 == nullptr || !frustum2->cullBox(*node.transformed_bbox))
+                m_models_queue.push_back(node_id);
+        }
+        else if(m_reg.has<LightComponent>(node_id))
+        {
+            m_lights_queue.push_back(node_id);
+        }
+
+        ++i;
+    }
 }
 
-void SceneSystem::updateQueuesRec(evnt::Frustum const & frustum1, evnt::Frustum const * frustum2,
-                                  Entity node_id)
+void SceneSystem::rebuildFlatHierarchy()
 {
-    auto const & node = m_reg.get<SceneComponent>(node_id);
+    m_flat_nodes.resize(0);
 
-    if(node.transformed_bbox && frustum1.cullBox(*node.transformed_bbox))
-    {
-        if(frustum2 == nullptr || frustum2->cullBox(*node.transformed_bbox))
-            return;
-    }
+    m_subtrees.resize(0);
 
-    // mesh nodes
-    if(m_reg.has<ModelComponent>(node_id) && node.transformed_bbox
-       && !frustum1.cullBox(*node.transformed_bbox))
+    if(NotNull(m_root))
     {
-        if(frustum2 == nullptr || !frustum2->cullBox(*node.transformed_bbox))
-            m_models_queue.push_back(node_id);
+        flattenRec(m_root, null_flat_index);
+
+        // independent subtrees under the root for the parallel update
+        uint32_t child = 1;
+        while(child < m_flat_nodes.size())
+        {
+            m_subtrees.push_back({child, m_flat_nodes[child].subtree_end, false});
+            child = m_flat_nodes[child].subtree_end;
+        }
     }
-    else if(m_reg.has<LightComponent>(node_id))
+
+    m_hierarchy_changed = false;
+}
+
+void SceneSystem::flattenRec(Entity node_id, uint32_t parent_index)
+{
+    auto const index = static_cast<uint32_t>(m_flat_nodes.size());
+    m_flat_nodes.push_back({node_id, parent_index, 0});
+
+    auto & node     = m_reg.get<HierarchyComponent>(node_id);
+    node.flat_index = index;
+    Entity child    = node.first_child;
+
+    while(NotNull(child))
     {
-        m_lights_queue.push_back(node_id);
+        flattenRec(child, index);
+        child = m_reg.get<HierarchyComponent>(child).next_sibling;
     }
 
-    for(auto ch : node.children)
+    m_flat_nodes[index].subtree_end = static_cast<uint32_t>(m_flat_nodes.size());
+}
+
+void SceneSystem::enableParallelUpdate(uint32_t num_threads)
+{
+    if(num_threads > 1)
+        m_thread_pool = std::make_unique<ThreadPool>(num_threads);
+    else
+        m_thread_pool.reset();
+}
+
+bool SceneSystem::isFlattened(Entity node_id) const
+{
+    auto const index = m_reg.get<HierarchyComponent>(node_id).flat_index;
+
+    return index < m_flat_nodes.size() && m_flat_nodes[index].entity == node_id;
+}
+
+void SceneSystem::markDirty(std::vector<Entity> & nodes, uint8_t flag, uint32_t & first_dirty)
+{
+    for(auto ent : nodes)
     {
-        updateQueuesRec(frustum1, frustum2, ch);
+        // skip destroyed nodes and nodes not connected to the scene root
+        if(!m_reg.valid(ent) || !m_reg.has<HierarchyComponent>(ent) || !isFlattened(ent))
+            continue;
+
+        auto const index = m_reg.get<HierarchyComponent>(ent).flat_index;
+        m_flat_nodes[index].dirty |= flag;
+        first_dirty = std::min(first_dirty, index);
     }
+
+    nodes.resize(0);
 }
 
-void SceneSystem::updateTransform(Entity node_id, bool initiator)
+void SceneSystem::propagateChanges()
 {
-    auto & node = m_reg.get<SceneComponent>(node_id);
+    if(m_dirty_transforms.empty() && m_dirty_bounds.empty())
+        return;
 
-    if(NotNull(node.parent))
+    if(m_hierarchy_changed)
+        rebuildFlatHierarchy();
+
+    auto first_dirty = static_cast<uint32_t>(m_flat_nodes.size());
+    markDirty(m_dirty_transforms, flat_transform_dirty, first_dirty);
+    markDirty(m_dirty_bounds, flat_bound_dirty, first_dirty);
+
+    auto const num_nodes = static_cast<uint32_t>(m_flat_nodes.size());
+
+    if(m_thread_pool && num_nodes >= parallel_min_nodes && m_subtrees.size() > 1)
     {
-        auto & parent_node = m_reg.get<SceneComponent>(node.parent);
-        node.abs           = parent_node.abs * node.rel;
+        propagateParallel(first_dirty);
     }
     else
     {
-        node.abs = node.rel;
+        updateWorldRange(first_dirty, num_nodes);
+        updateBoundRange(0, num_nodes);
     }
-    // mark entity
-    m_reg.add_component<Event::Scene::IsTransformed>(node_id);
 
-    for(auto ch : node.children)
+    // the listeners can't be called from worker threads, the bound flags are
+    // already cleared and moved nodes never precede first_dirty
+    for(uint32_t i = first_dirty; i < num_nodes; ++i)
     {
-        updateTransform(ch, false);
+        auto & flat = m_flat_nodes[i];
+
+        if(flat.dirty & flat_transform_dirty)
+            m_reg.notify_replace<WorldTransformComponent>(flat.entity);
+
+        flat.dirty = 0;
     }
+}
+
+void SceneSystem::propagateParallel(uint32_t first_dirty)
+{
+    // the root goes first, subtrees of its children are independent of each other
+    updateWorldRange(first_dirty, std::min(1u, static_cast<uint32_t>(m_flat_nodes.size())));
 
-    updateBound(node_id);
+    m_thread_pool->parallelFor(static_cast<uint32_t>(m_subtrees.size()), [this, first_dirty](uint32_t task) {
+        auto & subtree = m_subtrees[task];
 
-    if(initiator && NotNull(node.parent) && node.transformed_bbox)
-        propagateBoundToRoot(node.parent);
+        if(subtree.last > first_dirty)
+            updateWorldRange(std::max(subtree.first, first_dirty), subtree.last);
+
+        subtree.bound_changed = updateBoundRange(subtree.first, subtree.last);
+    });
+
+    // merge subtree bounds into the root
+    for(auto const & subtree : m_subtrees)
+    {
+        if(subtree.bound_changed)
+            m_flat_nodes[0].dirty |= flat_bound_dirty;
+    }
+
+    updateBoundRange(0, 1);
 }
 
-void SceneSystem::updateBound(Entity node_id)
+void SceneSystem::updateWorldRange(uint32_t first, uint32_t last)
 {
-    auto & node = m_reg.get<SceneComponent>(node_id);
+    // world matrices: parents precede children, the dirty flag is inherited
+    // from the parent, every node is visited once
+    for(uint32_t i = first; i < last; ++i)
+    {
+        auto & flat = m_flat_nodes[i];
+
+        if(flat.parent != null_flat_index && (m_flat_nodes[flat.parent].dirty & flat_transform_dirty))
+            flat.dirty |= flat_transform_dirty;
+
+        if(!(flat.dirty & flat_transform_dirty))
+            continue;
+
+        auto &       world = m_reg.get<WorldTransformComponent>(flat.entity);
+        auto const & local = m_reg.get<LocalTransformComponent>(flat.entity);
+
+        if(flat.parent != null_flat_index)
+        {
+            auto const & parent_world = m_reg.get<WorldTransformComponent>(m_flat_nodes[flat.parent].entity);
+            world.abs                 = parent_world.abs * local.rel;
+        }
+        else
+        {
+            world.abs = local.rel;
+        }
+
+        flat.dirty |= flat_bound_dirty;
+    }
+}
+
+bool SceneSystem::updateBoundRange(uint32_t first, uint32_t last)
+{
+    // bounds: children follow their parents, so a backward pass merges every
+    // changed child before its parent and walks each ancestor chain only once
+    bool first_changed = false;
+
+    for(uint32_t i = last; i > first; --i)
+    {
+        auto & flat = m_flat_nodes[i - 1];
+
+        if(!(flat.dirty & flat_bound_dirty))
+            continue;
+
+        flat.dirty &= ~flat_bound_dirty;
+
+        bool const changed = updateBound(i - 1);
+
+        if(i - 1 == first)
+            first_changed = changed;
+        else if(changed)
+            m_flat_nodes[flat.parent].dirty |= flat_bound_dirty;
+    }
+
+    return first_changed;
+}
+
+bool SceneSystem::updateBound(uint32_t index)
+{
+    auto const   node_id = m_flat_nodes[index].entity;
+    auto &       node    = m_reg.get<BoundsComponent>(node_id);
+    auto const & world   = m_reg.get<WorldTransformComponent>(node_id);
+    auto         old     = node.transformed_bbox;
 
     if(node.initial_bbox)
     {
         node.transformed_bbox = node.initial_bbox;
-        node.transformed_bbox->transform(node.abs);
+        node.transformed_bbox->transform(world.abs);
     }
     else
     {
@@ -201,10 +379,13 @@ void SceneSystem::updateBound(Entity node_id)
             node.transformed_bbox.reset();
     }
 
-    // expand from children
-    for(auto ch : node.children)
+    // expand from children, they start right after the node and each one
+    // is followed by its own subtree
+    auto const last  = m_flat_nodes[index].subtree_end;
+    uint32_t   child = index + 1;
+    while(child < last)
     {
-        auto & child_node = m_reg.get<SceneComponent>(ch);
+        auto const & child_node = m_reg.get<BoundsComponent>(m_flat_nodes[child].entity);
 
         if(child_node.transformed_bbox)
         {
@@ -213,14 +394,9 @@ void SceneSystem::updateBound(Entity node_id)
 
             node.transformed_bbox->expandBy(*child_node.transformed_bbox);
         }
-    }
-}
 
-void SceneSystem::propagateBoundToRoot(Entity parent_node_id)
-{
-    updateBound(parent_node_id);
+        child = m_flat_nodes[child].subtree_end;
+    }
 
-    auto const & node = m_reg.get<SceneComponent>(parent_node_id);
-    if(NotNull(node.parent))
-        propagateBoundToRoot(node.parent);
+    return old != node.transformed_bbox;
 }
@@ -2,24 +2,48 @@
 #define SCENECMP_H
 
 #include <glm/glm.hpp>
-#include <unordered_set>
+#include <limits>
+#include <memory>
 #include <string>
 #include <optional>
 #include "AABB.h"
+#include "affine.h"
 #include "sceneentitybuilder.h"
 #include "src/scene/frustum.h"
 
-struct SceneComponent
+// Scene node consist of next components, so every pass iterates only the
+// arrays it needs:
+//      [local_transform] [world_transform] [bounds]   - hot, transform propagation and culling
+//      [hierarchy] [name]                             - cold, hierarchy changes and tools
+struct LocalTransformComponent
+{
+    evnt::Affine rel;
+};
+
+struct WorldTransformComponent
+{
+    evnt::Affine abs;
+};
+
+struct BoundsComponent
 {
-    glm::mat4                 abs;
-    glm::mat4                 rel;
     std::optional<evnt::AABB> initial_bbox;
     std::optional<evnt::AABB> transformed_bbox;
-    std::string               name;
+};
 
-    Entity                     entity_id;
-    Entity                     parent;
-    std::unordered_set<Entity> children;
+struct HierarchyComponent
+{
+    Entity parent;
+    // intrusive first-child/next-sibling links, no per-node allocation
+    Entity   first_child;
+    Entity   next_sibling;
+    Entity   prev_sibling;
+    uint32_t flat_index;   // position in SceneSystem flat hierarchy
+};
+
+struct NameComponent
+{
+    std::string name;
 };
 
 namespace Event
@@ -32,27 +56,30 @@ namespace Scene
         bool      replase_local_matrix = false;
     };
 
-    struct IsTransformed
-    {};
-
     struct IsBboxUpdated
     {};
 }   // namespace Scene
 }   // namespace Event
 
+class ThreadPool;
+
 class SceneSystem : public ISystem
 {
 public:
-    static SceneComponent GetDefaultSceneComponent();
+    static HierarchyComponent GetDefaultHierarchyComponent();
 
-    SceneSystem(Registry & reg) : ISystem(reg) {}
+    SceneSystem(Registry & reg);
+    ~SceneSystem() override;
 
     // ISystem interface
     // bool        init() override;
     void        update(double time) override;
-    void        postUpdate() override;
     std::string getName() const override { return "Scene positions."; }
 
+    // world matrices and bounds of independent root subtrees are updated on
+    // num_threads threads, 0 or 1 switches back to the single-threaded update
+    void enableParallelUpdate(uint32_t num_threads);
+
     void connectNode(Entity node_id, Entity parent = null_entity_id);
     void disconnectNode(Entity node_id);
 
@@ -63,18 +90,53 @@ public:
     Entity                getRoot() const { return m_root; }
 
 private:
-    bool   m_transform_updated = false;
+    static constexpr uint32_t null_flat_index = std::numeric_limits<uint32_t>::max();
+
+    // hierarchy flattened in depth-first order: parents precede children and
+    // every subtree occupies the contiguous range [index, subtree_end)
+    struct FlatNode
+    {
+        Entity   entity      = null_entity_id;
+        uint32_t parent      = null_flat_index;
+        uint32_t subtree_end = 0;
+        uint8_t  dirty       = 0;
+    };
+
+    struct Subtree
+    {
+        uint32_t first         = 0;
+        uint32_t last          = 0;
+        bool     bound_changed = false;
+    };
+
+    static constexpr uint8_t flat_transform_dirty = 1;
+    static constexpr uint8_t flat_bound_dirty     = 2;
+
+    bool   m_hierarchy_changed = false;
     Entity m_root              = null_entity_id;   // root node of the scene
 
+    std::vector<FlatNode> m_flat_nodes;
+    std::vector<Subtree>  m_subtrees;   // children of the root
+    // nodes changed since the last update(), resolved in one batched pass
+    std::vector<Entity> m_dirty_transforms;
+    std::vector<Entity> m_dirty_bounds;
+
+    std::unique_ptr<ThreadPool> m_thread_pool;
+
     // Queues for culling
     std::vector<Entity> m_models_queue;
     std::vector<Entity> m_lights_queue;
 
-    void updateTransform(Entity ent, bool initiator);
-    void updateBound(Entity node_id);
-    void propagateBoundToRoot(Entity ent);
+    void rebuildFlatHierarchy();
+    void flattenRec(Entity node_id, uint32_t parent_index);
+    bool isFlattened(Entity node_id) const;
 
-    void updateQueuesRec(evnt::Frustum const & frustum1, evnt::Frustum const * frustum2, Entity node_id);
+    void markDirty(std::vector<Entity> & nodes, uint8_t flag, uint32_t & first_dirty);
+    void propagateChanges();
+    void propagateParallel(uint32_t first_dirty);
+    void updateWorldRange(uint32_t first, uint32_t last);
+    bool updateBoundRange(uint32_t first, uint32_t last);   // true if the bound of the first node has changed
+    bool updateBound(uint32_t index);   // true if the transformed bbox has changed
 };
 
 #endif   // SCENECMP_H
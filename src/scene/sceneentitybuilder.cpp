@@ -4,6 +4,7 @@
 #include "light.h"
 #include "material.h"
 #include "model.h"
+#include "src/utils/framearena.h"
 #include <algorithm>
 
 Entity EntityBuilder::BuildEntity(Registry & reg, build_flags flags)
@@ -14,9 +15,11 @@ Entity EntityBuilder::BuildEntity(Registry & reg, build_flags flags)
     {
         entity = reg.create();
 
-        auto scene      = SceneSystem::GetDefaultSceneComponent();
-        scene.entity_id = entity;
-        reg.assign<SceneComponent>(entity, scene);
+        reg.assign<LocalTransformComponent>(entity);
+        reg.assign<WorldTransformComponent>(entity);
+        reg.assign<BoundsComponent>(entity);
+        reg.assign<HierarchyComponent>(entity, SceneSystem::GetDefaultHierarchyComponent());
+        reg.assign<NameComponent>(entity);
     }
     if(flags[ComponentFlagsBitsPos::cam])
     {
@@ -109,11 +112,14 @@ void SystemsMgr::update(double time)
     {
         sys->postUpdate();
     }
+
+    // the frame data of this update is gone
+    FrameArena::ResetAll();
 }
 
 void EntityDeleterSystem::update(double time)
 {
-    std::vector<Entity> entities;
+    FrameVector<Entity> entities;
     for(auto ent : m_reg.view<Event::Deleter::DeleteEntity>())
     {
         entities.push_back(ent);
@@ -7,10 +7,12 @@
 #include <memory>
 #include <functional>
 
+#include "../ent/observer.hpp"
 #include "../ent/registry.hpp"
 
 using Entity   = entt::DefaultRegistry::entity_type;
 using Registry = entt::DefaultRegistry;
+using Observer = entt::Observer<Entity>;
 
 constexpr Entity null_entity_id = static_cast<Entity>(-1);
 
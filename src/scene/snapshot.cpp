@@ -0,0 +1,321 @@
+#include "snapshot.h"
+#include <array>
+#include <stdexcept>
+
+#include "assetcache.h"
+#include "camera.h"
+#include "light.h"
+#include "material.h"
+#include "model.h"
+#include "scenecmp.h"
+#include "streaming.h"
+#include "src/utils/binarystream.h"
+#include "src/utils/mappedfile.h"
+
+namespace
+{
+constexpr uint32_t snapshot_magic   = 0x53525950;   // "PYRS"
+constexpr uint32_t snapshot_version = 1;
+
+struct NodeRecord
+{
+    build_flags  flags;
+    int32_t      parent       = -1;   // index of the parent record
+    int32_t      parent_joint = -1;   // joint of the parent model the node is attached to
+    evnt::Affine rel;
+    std::string  name;
+    // the camera projection, the view follows from the transform
+    CameraComponent cam = CameraSystem::GetDefaultCamComponent();
+    LightComponent  light{};
+    // material colors, the textures come with the model
+    std::array<glm::vec4, 4> colors{};
+    float                    shininess = 0.0f;
+    // model source files
+    std::string mesh_name;
+    std::string anim_name;
+    std::string material_fname;
+};
+
+struct SaveContext
+{
+    Registry &   reg;
+    BinaryWriter out;
+    int32_t      num_records = 0;
+};
+
+void SaveChildren(SaveContext & ctx, Entity node_id, int32_t record, int32_t joint);
+
+void WriteAffine(BinaryWriter & out, evnt::Affine const & affine)
+{
+    out.write(affine.basis());
+    out.write(affine.origin());
+}
+
+bool ReadAffine(BinaryReader & in, evnt::Affine & affine)
+{
+    glm::mat3 basis;
+    glm::vec3 origin;
+    if(!in.read(basis) || !in.read(origin))
+        return false;
+
+    affine = evnt::Affine(basis, origin);
+    return true;
+}
+
+void SaveNode(SaveContext & ctx, Entity node_id, int32_t parent, int32_t parent_joint)
+{
+    auto & reg = ctx.reg;
+    auto & out = ctx.out;
+
+    if(reg.has<StreamedModelComponent>(node_id))
+        return;
+
+    build_flags flags = pos_flags;
+    flags.set(ComponentFlagsBitsPos::cam, reg.has<CameraComponent>(node_id));
+    flags.set(ComponentFlagsBitsPos::light, reg.has<LightComponent>(node_id));
+    flags.set(ComponentFlagsBitsPos::material, reg.has<MaterialComponent>(node_id));
+    // a model loads its textures into the material
+    flags.set(ComponentFlagsBitsPos::model,
+              reg.has<ModelComponent>(node_id) && reg.has<MaterialComponent>(node_id));
+
+    int32_t const record = ctx.num_records++;
+
+    out.write(static_cast<uint32_t>(flags.to_ulong()));
+    out.write(parent);
+    out.write(parent_joint);
+    WriteAffine(out, reg.get<LocalTransformComponent>(node_id).rel);
+    out.writeString(reg.get<NameComponent>(node_id).name);
+
+    if(flags[ComponentFlagsBitsPos::cam])
+    {
+        auto const & cam = reg.get<CameraComponent>(node_id);
+
+        out.write(cam.m_proj_mat);
+        out.write(std::array<float, 6>{cam.m_frust_left, cam.m_frust_right, cam.m_frust_bottom,
+                                       cam.m_frust_top, cam.m_frust_near, cam.m_frust_far});
+        out.write<uint8_t>(cam.m_orthographic ? 1 : 0);
+        out.write(cam.m_vp_pos);
+        out.write(cam.m_vp_size);
+    }
+
+    if(flags[ComponentFlagsBitsPos::light])
+        out.write(reg.get<LightComponent>(node_id));
+
+    if(flags[ComponentFlagsBitsPos::material])
+    {
+        auto const & mat = reg.get<MaterialComponent>(node_id);
+
+        out.write(std::array<glm::vec4, 4>{mat.m_ambient, mat.m_diffuse, mat.m_specular, mat.m_emission});
+        out.write(mat.m_shininess);
+    }
+
+    if(flags[ComponentFlagsBitsPos::model])
+    {
+        auto const & mdl       = reg.get<ModelComponent>(node_id);
+        auto const & mat_fname = reg.get<MaterialComponent>(node_id).m_diff_fname;
+
+        out.writeString(mdl.mesh_name);
+        out.writeString(mdl.anim_name);
+        out.writeString(mat_fname);
+
+        // the warm start reads blobs only
+        std::string const blob_fname = AssetCache::GetModelBlobName(mdl.mesh_name, mdl.anim_name, mat_fname);
+        if(!AssetCache::IsModelBlobCurrent(blob_fname))
+        {
+            ModelData data;
+            AssetCache::ReadModel(mdl.mesh_name, mdl.anim_name, mat_fname, data);
+        }
+    }
+
+    SaveChildren(ctx, node_id, record, -1);
+}
+
+void SaveChildren(SaveContext & ctx, Entity node_id, int32_t record, int32_t joint)
+{
+    std::vector<Entity> children;
+    for(Entity child = ctx.reg.get<HierarchyComponent>(node_id).first_child; NotNull(child);
+        child = ctx.reg.get<HierarchyComponent>(child).next_sibling)
+        children.push_back(child);
+
+    // SceneSystem::connectNode pushes to the front, the load keeps the order
+    for(auto it = children.rbegin(); it != children.rend(); ++it)
+    {
+        // joints are rebuilt with the model, the nodes on them are kept
+        if(ctx.reg.has<JointComponent>(*it))
+            SaveChildren(ctx, *it, record, ctx.reg.get<JointComponent>(*it).index);
+        else
+            SaveNode(ctx, *it, record, joint);
+    }
+}
+
+bool ReadNode(BinaryReader & in, NodeRecord & rec)
+{
+    uint32_t flags = 0;
+    if(!in.read(flags) || !in.read(rec.parent) || !in.read(rec.parent_joint) || !ReadAffine(in, rec.rel)
+       || !in.readString(rec.name))
+        return false;
+
+    rec.flags = build_flags(flags);
+    if(!rec.flags[ComponentFlagsBitsPos::pos] || rec.flags[ComponentFlagsBitsPos::joint])
+        return false;
+
+    if(rec.flags[ComponentFlagsBitsPos::cam])
+    {
+        auto &               cam = rec.cam;
+        std::array<float, 6> frustum;
+        uint8_t              orthographic = 0;
+        if(!in.read(cam.m_proj_mat) || !in.read(frustum) || !in.read(orthographic) || !in.read(cam.m_vp_pos)
+           || !in.read(cam.m_vp_size))
+            return false;
+
+        cam.m_frust_left   = frustum[0];
+        cam.m_frust_right  = frustum[1];
+        cam.m_frust_bottom = frustum[2];
+        cam.m_frust_top    = frustum[3];
+        cam.m_frust_near   = frustum[4];
+        cam.m_frust_far    = frustum[5];
+        cam.m_orthographic = orthographic != 0;
+    }
+
+    if(rec.flags[ComponentFlagsBitsPos::light] && !in.read(rec.light))
+        return false;
+
+    if(rec.flags[ComponentFlagsBitsPos::material] && (!in.read(rec.colors) || !in.read(rec.shininess)))
+        return false;
+
+    if(rec.flags[ComponentFlagsBitsPos::model]
+       && (!in.readString(rec.mesh_name) || !in.readString(rec.anim_name)
+           || !in.readString(rec.material_fname)))
+        return false;
+
+    return true;
+}
+}   // namespace
+
+bool SceneSnapshot::Save(Registry & reg, Entity root, std::string const & fname)
+{
+    if(!reg.valid(root))
+        return false;
+
+    SaveContext ctx{reg, {}, 0};
+    SaveNode(ctx, root, -1, -1);
+
+    BinaryWriter out;
+    out.write(snapshot_magic);
+    out.write(snapshot_version);
+    out.write(ctx.num_records);
+    out.writeBytes(ctx.out.getBuffer().data(), ctx.out.getBuffer().size());
+
+    return out.writeFile(fname);
+}
+
+bool SceneSnapshot::Load(Registry & reg, SceneSystem & scene, ModelSystem const & models,
+                         std::string const & fname)
+{
+    if(NotNull(scene.getRoot()))
+        return false;
+
+    MappedFile file;
+    if(!file.open(fname))
+        return false;
+
+    BinaryReader in(file.getData(), file.getSize());
+
+    // the whole file is checked before the first entity is created
+    uint32_t magic = 0, version = 0;
+    int32_t  num_records = 0;
+    if(!in.read(magic) || !in.read(version) || !in.read(num_records) || magic != snapshot_magic
+       || version != snapshot_version || num_records <= 0
+       || static_cast<uint64_t>(num_records) > in.getRemaining())
+        return false;
+
+    std::vector<NodeRecord> records(static_cast<size_t>(num_records));
+    for(int32_t i = 0; i < num_records; ++i)
+    {
+        auto & rec = records[static_cast<size_t>(i)];
+        // a single root first, parents before children
+        if(!ReadNode(in, rec) || (i == 0) != (rec.parent == -1) || rec.parent >= i)
+            return false;
+    }
+
+    if(!in.isEnd())
+        return false;
+
+    // and every model is read
+    std::vector<ModelData> model_data(records.size());
+    try
+    {
+        for(size_t i = 0; i < records.size(); ++i)
+        {
+            auto const & rec = records[i];
+            if(rec.flags[ComponentFlagsBitsPos::model])
+                AssetCache::ReadModel(rec.mesh_name, rec.anim_name, rec.material_fname, model_data[i]);
+        }
+    }
+    catch(std::runtime_error const &)
+    {
+        return false;
+    }
+
+    std::vector<Entity> entities;
+    for(auto & rec : records)
+    {
+        auto ent = EntityBuilder::BuildEntity(reg, rec.flags);
+
+        reg.get<LocalTransformComponent>(ent).rel = rec.rel;
+        reg.get<NameComponent>(ent).name          = std::move(rec.name);
+
+        if(rec.flags[ComponentFlagsBitsPos::cam])
+        {
+            // the view matrix is set up by CameraSystem after the first transform update
+            rec.cam.m_entity_id           = ent;
+            reg.get<CameraComponent>(ent) = rec.cam;
+        }
+
+        if(rec.flags[ComponentFlagsBitsPos::light])
+            reg.get<LightComponent>(ent) = rec.light;
+
+        if(rec.flags[ComponentFlagsBitsPos::model])
+        {
+            models.loadModel(ent, scene, std::move(model_data[entities.size()]));
+
+            // mark for render
+            reg.add_component<Event::Model::UploadBuffer>(ent);
+            reg.add_component<Event::Model::UploadTexture>(ent);
+        }
+
+        if(rec.flags[ComponentFlagsBitsPos::material])
+        {
+            auto & mat = reg.get<MaterialComponent>(ent);
+
+            mat.m_ambient   = rec.colors[0];
+            mat.m_diffuse   = rec.colors[1];
+            mat.m_specular  = rec.colors[2];
+            mat.m_emission  = rec.colors[3];
+            mat.m_shininess = rec.shininess;
+        }
+
+        if(rec.parent < 0)
+        {
+            scene.connectNode(ent);
+        }
+        else
+        {
+            Entity parent = entities[static_cast<size_t>(rec.parent)];
+            if(rec.parent_joint >= 0 && reg.has<ModelComponent>(parent))
+            {
+                // the model file may have changed since the save
+                auto const & joints = reg.get<ModelComponent>(parent).joint_id_to_entity;
+                auto const   joint  = static_cast<size_t>(rec.parent_joint);
+                if(joint < joints.size() && NotNull(joints[joint]))
+                    parent = joints[joint];
+            }
+
+            scene.connectNode(ent, parent);
+        }
+
+        entities.push_back(ent);
+    }
+
+    return true;
+}
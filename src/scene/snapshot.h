@@ -0,0 +1,28 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+
+#include "sceneentitybuilder.h"
+
+class SceneSystem;
+class ModelSystem;
+
+// Binary copy of the scene graph for a warm start. Every node is stored with
+// its local transform and its camera, light, material and model components,
+// parents before children. A model keeps the names of its source files only,
+// its data comes from the AssetCache blobs, skeletons are rebuilt by
+// ModelSystem::loadModel and nodes attached to a joint keep the joint index.
+// Entity ids aren't kept, the references are restored by position.
+class SceneSnapshot
+{
+public:
+    // writes the missing model blobs as well, streamed models are skipped
+    static bool Save(Registry & reg, Entity root, std::string const & fname);
+    // builds the saved nodes into a scene without a root, false if the file
+    // is missing or broken or a model can't be read and then nothing is created
+    static bool Load(Registry & reg, SceneSystem & scene, ModelSystem const & models,
+                     std::string const & fname);
+};
+
+#endif   // SNAPSHOT_H
@@ -0,0 +1,233 @@
+#include "streaming.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "camera.h"
+#include "material.h"
+#include "model.h"
+#include "scenecmp.h"
+
+WorldStreamer::WorldStreamer(Registry & reg, SceneSystem & scene, StreamingSettings const & settings) :
+    ISystem(reg), m_scene(scene), m_settings(settings)
+{}
+
+WorldStreamer::~WorldStreamer()
+{
+    for(auto & cell : m_cells)
+    {
+        if(cell.pending.valid())
+            cell.pending.wait();
+    }
+}
+
+void WorldStreamer::addModel(WorldModelDesc desc)
+{
+    glm::vec3 const  pos   = desc.transform[3];
+    glm::ivec2 const coord(static_cast<int>(std::floor(pos.x / m_settings.cell_size)),
+                           static_cast<int>(std::floor(pos.z / m_settings.cell_size)));
+    uint64_t const   key   = (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32u)
+                         | static_cast<uint32_t>(coord.y);
+
+    auto it = m_cell_index.find(key);
+    if(it == m_cell_index.end())
+    {
+        Cell cell;
+        cell.center = (glm::vec2(coord) + 0.5f) * m_settings.cell_size;
+
+        it = m_cell_index.emplace(key, static_cast<uint32_t>(m_cells.size())).first;
+        m_order.push_back(static_cast<uint32_t>(m_cells.size()));
+        m_cells.push_back(std::move(cell));
+    }
+
+    // a resident cell creates the new model on its next load
+    m_cells[it->second].models.push_back(static_cast<uint32_t>(m_models.size()));
+    m_models.push_back(std::move(desc));
+}
+
+bool WorldStreamer::loadWorld(std::string const & fname)
+{
+    std::ifstream in(fname, std::ios::in);
+    if(!in)
+        return false;
+
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.substr(0, 5) != "model")
+            continue;
+
+        std::istringstream s(line.substr(5));
+        WorldModelDesc     desc;
+        glm::vec3          pos(0.0f);
+        s >> desc.mesh_name >> desc.anim_name >> desc.material_name >> pos.x >> pos.y >> pos.z;
+        if(!s)
+            return false;
+
+        if(desc.anim_name == "-")
+            desc.anim_name.clear();
+        desc.transform = glm::translate(glm::mat4(1.0f), pos);
+
+        addModel(std::move(desc));
+    }
+
+    return true;
+}
+
+uint32_t WorldStreamer::getNumResidentCells() const
+{
+    return static_cast<uint32_t>(std::count_if(m_cells.begin(), m_cells.end(), [](Cell const & cell) {
+        return cell.state == CellState::Resident;
+    }));
+}
+
+void WorldStreamer::update(double time)
+{
+    if(m_cells.empty() || !m_reg.valid(m_viewer))
+        return;
+
+    glm::vec3 const viewer = m_reg.get<CameraComponent>(m_viewer).m_abs_pos;
+    for(auto & cell : m_cells)
+        cell.distance = glm::distance(cell.center, glm::vec2(viewer.x, viewer.z));
+
+    std::sort(m_order.begin(), m_order.end(),
+              [this](uint32_t lhs, uint32_t rhs) { return m_cells[lhs].distance < m_cells[rhs].distance; });
+
+    // reads finished since the last update
+    for(auto & cell : m_cells)
+    {
+        if(cell.state == CellState::Reading
+           && cell.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            finishRead(cell);
+    }
+
+    for(auto & cell : m_cells)
+    {
+        if(cell.state == CellState::Resident && cell.distance > m_settings.unload_radius)
+            unloadCell(cell);
+    }
+
+    // nearest cells first, a cell that doesn't fit into the budget takes the
+    // place of the farthest resident ones if they make enough room, else it
+    // waits and the farther cells go on
+    for(auto index : m_order)
+    {
+        auto & cell = m_cells[index];
+        if(cell.distance > m_settings.load_radius || m_num_reading >= m_settings.max_reads)
+            break;
+
+        if(cell.state != CellState::Unloaded)
+            continue;
+
+        uint64_t farther_bytes = 0;
+        for(auto far = m_order.rbegin(); *far != index; ++far)
+        {
+            if(m_cells[*far].state == CellState::Resident)
+                farther_bytes += m_cells[*far].bytes;
+        }
+
+        if(m_resident_bytes + m_reading_bytes + cell.bytes > m_settings.budget + farther_bytes)
+            continue;
+
+        for(auto far = m_order.rbegin(); *far != index && !fits(cell); ++far)
+        {
+            if(m_cells[*far].state == CellState::Resident)
+                unloadCell(m_cells[*far]);
+        }
+
+        startRead(cell);
+    }
+}
+
+WorldStreamer::CellData WorldStreamer::ReadCell(std::vector<WorldModelDesc> descs)
+{
+    CellData data;
+    for(auto const & desc : descs)
+    {
+        data.push_back(std::make_shared<ModelData>());
+        ModelSystem::ReadModel(desc.mesh_name, desc.anim_name, desc.material_name, *data.back());
+    }
+
+    return data;
+}
+
+bool WorldStreamer::fits(Cell const & cell) const
+{
+    // the size of a cell is known after its first read
+    return m_resident_bytes + m_reading_bytes + cell.bytes <= m_settings.budget;
+}
+
+void WorldStreamer::startRead(Cell & cell)
+{
+    std::vector<WorldModelDesc> descs;
+    for(auto model : cell.models)
+        descs.push_back(m_models[model]);
+
+    cell.pending = std::async(std::launch::async, &WorldStreamer::ReadCell, std::move(descs));
+    cell.state   = CellState::Reading;
+
+    m_reading_bytes += cell.bytes;
+    ++m_num_reading;
+}
+
+void WorldStreamer::finishRead(Cell & cell)
+{
+    // read errors are thrown here, as from ModelSystem::loadModel
+    CellData data = cell.pending.get();
+
+    m_reading_bytes -= cell.bytes;
+    --m_num_reading;
+
+    cell.bytes = 0;
+    for(auto const & mdl_data : data)
+    {
+        cell.bytes += ModelSystem::GetMeshBytes(mdl_data->mdl) + ModelSystem::GetAnimBytes(mdl_data->mdl)
+                      + MaterialSystem::GetMemoryUsage(mdl_data->mat);
+    }
+
+    // never fits, it isn't read again
+    if(cell.bytes > m_settings.budget)
+    {
+        cell.state = CellState::Oversized;
+        return;
+    }
+
+    // the viewer has moved away or the cell was larger than expected
+    if(cell.distance > m_settings.unload_radius || m_resident_bytes + cell.bytes > m_settings.budget)
+    {
+        cell.state = CellState::Unloaded;
+        return;
+    }
+
+    for(size_t i = 0; i < data.size(); ++i)
+    {
+        auto const & desc = m_models[cell.models[i]];
+        auto         ent  = EntityBuilder::BuildEntity(m_reg, obj_flags);
+
+        Event::Model::CreateModel cm_event{m_scene.getRoot(), desc.mesh_name, desc.anim_name,
+                                           desc.material_name, desc.transform, std::move(data[i])};
+
+        m_reg.add_component<Event::Model::CreateModel>(ent, std::move(cm_event));
+        m_reg.assign<StreamedModelComponent>(ent);
+        cell.entities.push_back(ent);
+    }
+
+    m_resident_bytes += cell.bytes;
+    cell.state = CellState::Resident;
+}
+
+void WorldStreamer::unloadCell(Cell & cell)
+{
+    for(auto ent : cell.entities)
+    {
+        if(m_reg.valid(ent))
+            m_reg.add_component<Event::Model::DestroyModel>(ent);
+    }
+    cell.entities.clear();
+
+    m_resident_bytes -= cell.bytes;
+    cell.state = CellState::Unloaded;
+}
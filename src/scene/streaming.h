@@ -0,0 +1,101 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "sceneentitybuilder.h"
+
+class SceneSystem;
+struct ModelData;
+
+struct WorldModelDesc
+{
+    std::string mesh_name;
+    std::string anim_name;
+    std::string material_name;
+    glm::mat4   transform{1.0f};
+};
+
+struct StreamingSettings
+{
+    float    cell_size     = 16.0f;
+    float    load_radius   = 32.0f;
+    float    unload_radius = 48.0f;           // cells between the radii keep their state
+    uint64_t budget        = 256ull << 20u;   // bytes of the model data as read from the files
+    uint32_t max_reads     = 2;               // cells read at the same time
+};
+
+// tag of the models owned by a WorldStreamer, they aren't part of a scene snapshot
+struct StreamedModelComponent
+{};
+
+// Keeps the models of a world around the viewer resident. The world is split
+// into square cells on the xz plane by the model positions, the files of a
+// cell are read on a worker thread, nearest cells first, and the models are
+// created with Event::Model::CreateModel. Cells out of the unload radius and
+// the farthest cells over the memory budget go with Event::Model::DestroyModel.
+class WorldStreamer : public ISystem
+{
+public:
+    WorldStreamer(Registry & reg, SceneSystem & scene, StreamingSettings const & settings = {});
+    ~WorldStreamer() override;   // waits for the reads in flight
+
+    void        update(double time = 1.0) override;
+    std::string getName() const override { return "WorldStreamer"; }
+
+    void addModel(WorldModelDesc desc);
+    // a model per line: model <mesh> <anim or -> <material> <x> <y> <z>
+    bool loadWorld(std::string const & fname);
+    // cells are streamed around the position of this camera
+    void setViewer(Entity camera) { m_viewer = camera; }
+
+    uint64_t getResidentBytes() const { return m_resident_bytes; }
+    uint32_t getNumResidentCells() const;
+
+private:
+    enum class CellState
+    {
+        Unloaded,
+        Reading,
+        Resident,
+        Oversized   // larger than the whole budget, not read again
+    };
+
+    using CellData = std::vector<std::shared_ptr<ModelData>>;
+
+    struct Cell
+    {
+        glm::vec2             center{0.0f};
+        std::vector<uint32_t> models;   // indexes in m_models
+        CellState             state = CellState::Unloaded;
+        std::vector<Entity>   entities;
+        uint64_t              bytes = 0;   // of the last read, 0 before the first one
+        std::future<CellData> pending;
+        float                 distance = 0.0f;
+    };
+
+    SceneSystem &                          m_scene;
+    StreamingSettings const                m_settings;
+    Entity                                 m_viewer = null_entity_id;
+    std::vector<WorldModelDesc>            m_models;
+    std::vector<Cell>                      m_cells;
+    std::unordered_map<uint64_t, uint32_t> m_cell_index;   // packed cell coordinates to m_cells
+    std::vector<uint32_t>                  m_order;        // cells by distance to the viewer
+    uint64_t                               m_resident_bytes = 0;
+    uint64_t                               m_reading_bytes  = 0;   // known sizes of the cells in reading
+    uint32_t                               m_num_reading    = 0;
+
+    static CellData ReadCell(std::vector<WorldModelDesc> descs);
+
+    bool fits(Cell const & cell) const;
+    void finishRead(Cell & cell);
+    void startRead(Cell & cell);
+    void unloadCell(Cell & cell);
+};
+
+#endif   // STREAMING_H
@@ -0,0 +1,152 @@
+#include "allocstats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+
+namespace
+{
+std::atomic<uint64_t> g_num_allocations{0};
+
+std::array<std::atomic<uint64_t>, MemoryReport::num_tags> g_tag_allocations{};
+std::array<std::atomic<uint64_t>, MemoryReport::num_tags> g_tag_bytes{};
+
+thread_local MemTag g_current_tag = MemTag::Other;
+
+void * CountedAlloc(std::size_t size) noexcept
+{
+    auto const tag = static_cast<uint32_t>(g_current_tag);
+
+    g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_tag_allocations[tag].fetch_add(1, std::memory_order_relaxed);
+    g_tag_bytes[tag].fetch_add(size, std::memory_order_relaxed);
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+double ToKb(uint64_t bytes)
+{
+    return static_cast<double>(bytes) / 1024.0;
+}
+}   // namespace
+
+uint64_t GetHeapAllocations()
+{
+    return g_num_allocations.load(std::memory_order_relaxed);
+}
+
+char const * GetMemTagName(MemTag tag)
+{
+    switch(tag)
+    {
+        case MemTag::Other:
+            return "other";
+        case MemTag::Mesh:
+            return "mesh";
+        case MemTag::Animation:
+            return "animation";
+        case MemTag::Image:
+            return "image";
+        case MemTag::Ecs:
+            return "ecs";
+        case MemTag::Render:
+            return "render";
+        case MemTag::Count:
+            break;
+    }
+
+    return "unknown";
+}
+
+MemTagScope::MemTagScope(MemTag tag) : m_prev(g_current_tag)
+{
+    g_current_tag = tag;
+}
+
+MemTagScope::~MemTagScope()
+{
+    g_current_tag = m_prev;
+}
+
+HeapTagStats GetHeapStats(MemTag tag)
+{
+    auto const index = static_cast<uint32_t>(tag);
+
+    return {g_tag_allocations[index].load(std::memory_order_relaxed),
+            g_tag_bytes[index].load(std::memory_order_relaxed)};
+}
+
+void MemoryReport::write(std::ostream & out) const
+{
+    uint64_t total = 0;
+
+    out << "memory by tag: live kb / allocated kb / allocations\n";
+    for(uint32_t i = 0; i < num_tags; ++i)
+    {
+        auto const tag  = static_cast<MemTag>(i);
+        auto const heap = GetHeapStats(tag);
+
+        out << "  " << GetMemTagName(tag) << ": " << ToKb(cpu_bytes[i]) << " / " << ToKb(heap.bytes) << " / "
+            << heap.allocations << "\n";
+        total += cpu_bytes[i];
+    }
+
+    out << "  cpu total: " << ToKb(total) << "\n"
+        << "  gpu buffers: " << ToKb(gpu_buffer_bytes) << " (" << ToKb(gpu_buffer_used) << " used)\n"
+        << "  gpu textures: " << ToKb(gpu_texture_bytes) << std::endl;
+}
+
+// every unaligned form is replaced, so memory from one of them may be
+// released by any of the deletes, the aligned forms stay the default ones
+void * operator new(std::size_t size)
+{
+    if(void * ptr = CountedAlloc(size))
+        return ptr;
+
+    throw std::bad_alloc{};
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void * operator new(std::size_t size, std::nothrow_t const &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void * operator new[](std::size_t size, std::nothrow_t const &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::nothrow_t const &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::nothrow_t const &) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,72 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Heap allocations through the global operator new since the start, the
+// count is kept by the replaced operator new in allocstats.cpp. The frame
+// loop compares it before and after a frame.
+uint64_t GetHeapAllocations();
+
+// subsystems the memory is accounted to
+enum class MemTag : uint32_t
+{
+    Other,
+    Mesh,
+    Animation,
+    Image,
+    Ecs,
+    Render,
+    Count
+};
+
+char const * GetMemTagName(MemTag tag);
+
+// allocations of this thread while the scope lives are counted under the tag
+class MemTagScope
+{
+public:
+    explicit MemTagScope(MemTag tag);
+    ~MemTagScope();
+
+    MemTagScope(MemTagScope const &)             = delete;
+    MemTagScope & operator=(MemTagScope const &) = delete;
+
+private:
+    MemTag m_prev;
+};
+
+struct HeapTagStats
+{
+    uint64_t allocations = 0;
+    uint64_t bytes       = 0;   // requested, freed memory isn't subtracted
+};
+
+HeapTagStats GetHeapStats(MemTag tag);
+
+// Live memory by subsystem, the owners add the storage their containers
+// hold, see the accountMemory functions. The heap totals per tag are
+// written next to it.
+struct MemoryReport
+{
+    static constexpr uint32_t num_tags = static_cast<uint32_t>(MemTag::Count);
+
+    std::array<uint64_t, num_tags> cpu_bytes         = {};
+    uint64_t                       gpu_buffer_bytes  = 0;   // allocated GL buffer storage
+    uint64_t                       gpu_buffer_used   = 0;   // of that in use by models
+    uint64_t                       gpu_texture_bytes = 0;
+
+    void add(MemTag tag, uint64_t bytes) { cpu_bytes[static_cast<uint32_t>(tag)] += bytes; }
+    void write(std::ostream & out) const;
+};
+
+template<typename T, typename Alloc>
+uint64_t VectorBytes(std::vector<T, Alloc> const & vec)
+{
+    return vec.capacity() * sizeof(T);
+}
+
+#endif   // ALLOCSTATS_H
@@ -0,0 +1,22 @@
+#include "binarystream.h"
+#include <cstdio>
+#include <fstream>
+
+bool BinaryWriter::writeFile(std::string const & fname) const
+{
+    // a reader never sees a half written file
+    std::string const tmp_fname = fname + ".tmp";
+    {
+        std::ofstream out(tmp_fname, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!out)
+            return false;
+
+        out.write(reinterpret_cast<char const *>(m_buffer.data()),
+                  static_cast<std::streamsize>(m_buffer.size()));
+        if(!out)
+            return false;
+    }
+
+    std::remove(fname.c_str());
+    return std::rename(tmp_fname.c_str(), fname.c_str()) == 0;
+}
@@ -0,0 +1,116 @@
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Native endian binary data, values are copied as they are in memory, so
+// only trivially copyable types go through write/read. Files are read back
+// by the same build on the same platform.
+class BinaryWriter
+{
+public:
+    template<typename T>
+    void write(T const & value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "write a trivially copyable type");
+        writeBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void writeVector(std::vector<T> const & vec)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "write a trivially copyable type");
+        write<uint64_t>(vec.size());
+        writeBytes(vec.data(), vec.size() * sizeof(T));
+    }
+
+    void writeString(std::string const & str)
+    {
+        write<uint64_t>(str.size());
+        writeBytes(str.data(), str.size());
+    }
+
+    void writeBytes(void const * data, size_t size)
+    {
+        auto const * bytes = static_cast<uint8_t const *>(data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+
+    std::vector<uint8_t> const & getBuffer() const { return m_buffer; }
+    void                         clear() { m_buffer.clear(); }
+    bool                         writeFile(std::string const & fname) const;
+
+private:
+    std::vector<uint8_t> m_buffer;
+};
+
+// reads from a memory block, a read past the end fails and leaves the value
+// untouched, the reader stays failed afterwards
+class BinaryReader
+{
+public:
+    BinaryReader(uint8_t const * data, size_t size) : m_data(data), m_size(size) {}
+
+    template<typename T>
+    bool read(T & value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "read a trivially copyable type");
+        return readBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    bool readVector(std::vector<T> & vec)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "read a trivially copyable type");
+        uint64_t num = 0;
+        if(!read(num) || num > (m_size - m_offset) / sizeof(T))
+            return fail();
+
+        vec.resize(static_cast<size_t>(num));
+        return readBytes(vec.data(), vec.size() * sizeof(T));
+    }
+
+    bool readString(std::string & str)
+    {
+        uint64_t num = 0;
+        if(!read(num) || num > m_size - m_offset)
+            return fail();
+
+        str.assign(reinterpret_cast<char const *>(m_data + m_offset), static_cast<size_t>(num));
+        m_offset += static_cast<size_t>(num);
+        return true;
+    }
+
+    bool readBytes(void * out, size_t size)
+    {
+        if(m_failed || size > m_size - m_offset)
+            return fail();
+
+        if(size > 0)
+            std::memcpy(out, m_data + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    bool   isFailed() const { return m_failed; }
+    bool   isEnd() const { return m_offset == m_size; }
+    size_t getRemaining() const { return m_size - m_offset; }
+
+private:
+    uint8_t const * m_data   = nullptr;
+    size_t          m_size   = 0;
+    size_t          m_offset = 0;
+    bool            m_failed = false;
+
+    bool fail()
+    {
+        m_failed = true;
+        return false;
+    }
+};
+
+#endif   // BINARYSTREAM_H
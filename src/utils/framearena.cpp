@@ -0,0 +1,74 @@
+#include "framearena.h"
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+
+namespace
+{
+std::mutex                g_arenas_mutex;
+std::vector<FrameArena *> g_arenas;
+
+size_t AlignUp(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+}   // namespace
+
+FrameArena::FrameArena() : m_block(new uint8_t[initial_size]), m_capacity(initial_size)
+{
+    std::lock_guard<std::mutex> lock(g_arenas_mutex);
+    g_arenas.push_back(this);
+}
+
+FrameArena::~FrameArena()
+{
+    std::lock_guard<std::mutex> lock(g_arenas_mutex);
+    g_arenas.erase(std::remove(g_arenas.begin(), g_arenas.end(), this), g_arenas.end());
+}
+
+void * FrameArena::allocate(size_t size, size_t align)
+{
+    // new[] storage is aligned for any fundamental type
+    assert(align <= alignof(std::max_align_t));
+
+    auto const base   = reinterpret_cast<uintptr_t>(m_block.get());
+    size_t     offset = AlignUp(base + m_offset, align) - base;
+    if(offset + size <= m_capacity)
+    {
+        m_offset = offset + size;
+        return m_block.get() + offset;
+    }
+
+    m_overflow.emplace_back(new uint8_t[size]);
+    m_overflow_size += size;
+
+    return m_overflow.back().get();
+}
+
+void FrameArena::reset()
+{
+    if(!m_overflow.empty())
+    {
+        // with room for the alignment of the former overflow blocks
+        m_capacity = m_offset + m_overflow_size + m_overflow.size() * alignof(std::max_align_t);
+        m_block.reset(new uint8_t[m_capacity]);
+
+        m_overflow.clear();
+        m_overflow_size = 0;
+    }
+
+    m_offset = 0;
+}
+
+FrameArena & FrameArena::Local()
+{
+    thread_local FrameArena arena;
+    return arena;
+}
+
+void FrameArena::ResetAll()
+{
+    std::lock_guard<std::mutex> lock(g_arenas_mutex);
+    for(auto arena : g_arenas)
+        arena->reset();
+}
@@ -0,0 +1,81 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Linear allocator for data that lives until the end of the frame. Every
+// thread has its own arena, an allocation only moves a pointer and nothing is
+// freed before the reset. Allocations that don't fit go to overflow blocks,
+// the next reset grows the arena to the peak use, so a frame in the steady
+// state doesn't touch the heap.
+class FrameArena
+{
+public:
+    static constexpr size_t initial_size = 64 * 1024;
+
+    FrameArena();
+    ~FrameArena();
+
+    FrameArena(FrameArena const &)             = delete;
+    FrameArena & operator=(FrameArena const &) = delete;
+
+    void * allocate(size_t size, size_t align);
+    void   reset();
+
+    size_t getUsed() const { return m_offset + m_overflow_size; }
+    size_t getCapacity() const { return m_capacity; }
+
+    // arena of the calling thread
+    static FrameArena & Local();
+    // resets the arenas of all threads, none of them may hold frame data
+    static void ResetAll();
+
+private:
+    std::unique_ptr<uint8_t[]>              m_block;
+    size_t                                  m_capacity = 0;
+    size_t                                  m_offset   = 0;
+    std::vector<std::unique_ptr<uint8_t[]>> m_overflow;
+    size_t                                  m_overflow_size = 0;
+};
+
+// STL adapter, memory is given back by FrameArena::reset only
+template<typename T>
+class FrameAllocator
+{
+public:
+    using value_type = T;
+
+    FrameAllocator() noexcept : m_arena(&FrameArena::Local()) {}
+    explicit FrameAllocator(FrameArena & arena) noexcept : m_arena(&arena) {}
+    template<typename U>
+    FrameAllocator(FrameAllocator<U> const & other) noexcept : m_arena(other.getArena())
+    {}
+
+    T * allocate(size_t num) { return static_cast<T *>(m_arena->allocate(num * sizeof(T), alignof(T))); }
+    void deallocate(T *, size_t) noexcept {}
+
+    FrameArena * getArena() const noexcept { return m_arena; }
+
+private:
+    FrameArena * m_arena;
+};
+
+template<typename T, typename U>
+bool operator==(FrameAllocator<T> const & lhs, FrameAllocator<U> const & rhs) noexcept
+{
+    return lhs.getArena() == rhs.getArena();
+}
+
+template<typename T, typename U>
+bool operator!=(FrameAllocator<T> const & lhs, FrameAllocator<U> const & rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+#endif   // FRAMEARENA_H
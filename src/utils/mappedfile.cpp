@@ -0,0 +1,108 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(std::string const & fname)
+{
+    close();
+
+    HANDLE file = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<uint8_t const *>(data);
+    m_size    = static_cast<size_t>(size.QuadPart);
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if(m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if(m_file != nullptr)
+        CloseHandle(m_file);
+
+    m_data    = nullptr;
+    m_size    = 0;
+    m_mapping = nullptr;
+    m_file    = nullptr;
+}
+#else
+bool MappedFile::open(std::string const & fname)
+{
+    close();
+
+    int const fd = ::open(fname.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    auto const size = static_cast<size_t>(st.st_size);
+    void *     data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive
+    ::close(fd);
+    if(data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<uint8_t const *>(data);
+    m_size = size;
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(m_data != nullptr)
+        munmap(const_cast<uint8_t *>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
@@ -0,0 +1,35 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read only view of a whole file mapped into memory, the pages are read on
+// first access and shared with the page cache
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile const &)             = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+
+    // false for missing and empty files
+    bool open(std::string const & fname);
+    void close();
+
+    uint8_t const * getData() const { return m_data; }
+    size_t          getSize() const { return m_size; }
+
+private:
+    uint8_t const * m_data = nullptr;
+    size_t          m_size = 0;
+#ifdef _WIN32
+    void * m_file    = nullptr;   // HANDLE
+    void * m_mapping = nullptr;   // HANDLE
+#endif
+};
+
+#endif   // MAPPEDFILE_H
@@ -0,0 +1,85 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(uint32_t num_threads)
+{
+    for(uint32_t i = 1; i < num_threads; ++i)
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start_cv.notify_all();
+
+    for(auto & thr : m_workers)
+        thr.join();
+}
+
+void ThreadPool::parallelFor(uint32_t num_tasks, TaskFunc const & func)
+{
+    if(num_tasks == 0)
+        return;
+
+    if(m_workers.empty() || num_tasks == 1)
+    {
+        for(uint32_t i = 0; i < num_tasks; ++i)
+            func(i);
+
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_func         = &func;
+        m_num_tasks    = num_tasks;
+        m_busy_workers = static_cast<uint32_t>(m_workers.size());
+        m_next_task.store(0);
+        ++m_generation;
+    }
+    m_start_cv.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cv.wait(lock, [this] { return m_busy_workers == 0; });
+    m_func = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+    uint64_t last_generation = 0;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cv.wait(lock, [this, last_generation] { return m_stop || m_generation != last_generation; });
+
+            if(m_stop)
+                return;
+
+            last_generation = m_generation;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy_workers;
+        }
+        m_done_cv.notify_one();
+    }
+}
+
+void ThreadPool::runTasks()
+{
+    uint32_t task = m_next_task.fetch_add(1);
+    while(task < m_num_tasks)
+    {
+        (*m_func)(task);
+        task = m_next_task.fetch_add(1);
+    }
+}
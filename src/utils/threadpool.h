@@ -0,0 +1,48 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part in the work, so ThreadPool(1) runs everything inline.
+class ThreadPool
+{
+public:
+    using TaskFunc = std::function<void(uint32_t)>;
+
+    explicit ThreadPool(uint32_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const &)             = delete;
+    ThreadPool & operator=(ThreadPool const &) = delete;
+
+    uint32_t getNumThreads() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+    // calls func(task_index) for every index in [0, num_tasks) and blocks until
+    // all of them are done, tasks are handed out one by one for load balancing
+    void parallelFor(uint32_t num_tasks, TaskFunc const & func);
+
+private:
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_start_cv;
+    std::condition_variable  m_done_cv;
+
+    TaskFunc const *      m_func      = nullptr;
+    uint32_t              m_num_tasks = 0;
+    std::atomic<uint32_t> m_next_task{0};
+    uint32_t              m_busy_workers = 0;
+    uint64_t              m_generation   = 0;
+    bool                  m_stop         = false;
+};
+
+#endif   // THREADPOOL_H
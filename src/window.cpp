@@ -1,11 +1,49 @@
 #include "window.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 #include <stdexcept>
+#include <thread>
 
 #include "scene/camera.h"
 #include "render/renderer.h"
 #include "scene/light.h"
+#include "scene/snapshot.h"
+#include "ent/snapshot.hpp"
 #include "input/inputglfw.h"
+#include "res/imagedata.h"
+#include "utils/allocstats.h"
+#include "utils/binarystream.h"
+
+// the float components of the scene state, the sizes add up to the members
+namespace entt
+{
+template<>
+struct is_padding_free<LocalTransformComponent>
+    : std::bool_constant<sizeof(LocalTransformComponent) == sizeof(glm::mat3) + sizeof(glm::vec3)>
+{};
+
+template<>
+struct is_padding_free<WorldTransformComponent>
+    : std::bool_constant<sizeof(WorldTransformComponent) == sizeof(glm::mat3) + sizeof(glm::vec3)>
+{};
+
+template<>
+struct is_padding_free<CameraComponent>
+    : std::bool_constant<sizeof(CameraComponent)
+                         == sizeof(Entity) + 2 * sizeof(glm::mat4) + 6 * sizeof(evnt::Plane)
+                                + 10 * sizeof(glm::vec3) + 2 * sizeof(glm::ivec2) + 6 * sizeof(float)
+                                + sizeof(uint32_t)>
+{};
+
+template<>
+struct is_padding_free<LightComponent>
+    : std::bool_constant<sizeof(LightComponent) == sizeof(LightType) + 4 * sizeof(glm::vec4)
+                                                       + 2 * sizeof(glm::vec3) + 2 * sizeof(float)>
+{};
+}   // namespace entt
 
 namespace
 {
@@ -14,19 +52,68 @@ char const * anim_fname        = "test.txt.anm";
 char const * diffuse_tex_fname = "uv.tga";
 // char const *    bump_tex_fname    = "normal.tga";
 constexpr float def_speed = 0.02f;
+// run() passes the glfw time / 10, at 60 fps
+constexpr double headless_time_step = 1.0 / 600.0;
+
+// the per frame scene state, models and materials come with the events
+using SceneState = entt::Snapshot<Entity, LocalTransformComponent, WorldTransformComponent,
+                                  HierarchyComponent, CameraComponent, LightComponent, CurrentAnimSequence>;
+
+constexpr uint32_t state_record_magic   = 0x52525950;   // "PYRR"
+constexpr uint32_t state_record_version = 1;
+
+template<typename Component>
+bool SamePool(Registry & reg, Registry const & replay)
+{
+    if(reg.size<Component>() != replay.size<Component>())
+        return false;
+
+    // the components are free of padding
+    for(auto ent : reg.view<Component>())
+    {
+        if(!replay.valid(ent) || !replay.has<Component>(ent)
+           || std::memcmp(&reg.get<Component>(ent), &replay.get<Component>(ent), sizeof(Component)) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+// the replayed registry holds the entities and recorded components of reg
+template<typename... Component>
+bool SameState(entt::Snapshot<Entity, Component...> const &, Registry & reg, Registry const & replay)
+{
+    return reg.size() == replay.size() && reg.capacity() == replay.capacity()
+           && (SamePool<Component>(reg, replay) && ...);
+}
 }   // namespace
 
-Window::Window(int width, int height, char const * title) :
+Window::Window(int width, int height, char const * title, std::unique_ptr<RenderBackend> backend,
+               bool offscreen, std::string const & snapshot_fname) :
     m_size{width, height},
     m_title{title},
+    m_headless{offscreen || !backend->needsContext()},
     m_arcball{static_cast<uint32_t>(width), static_cast<uint32_t>(height)},
     m_reg{},
-    m_sys{}
+    m_sys{},
+    m_frame_builder{m_reg}
 {
+    if(offscreen && backend->needsContext())
+        m_offscreen = std::make_unique<OffscreenContext>();
+
     // Create scene
-    if(!createDefaultScene(width, height))
+    if(!createSystems(std::move(backend)))
+        throw std::runtime_error{"Failed to create systems."};
+
+    m_restored = !snapshot_fname.empty() && restoreScene(snapshot_fname);
+    if(!m_restored && !createDefaultScene(width, height))
         throw std::runtime_error{"Failed to create scene."};
 
+    m_streamer->setViewer(m_camera);
+
+    if(m_headless)
+        return;
+
     // Initialise GLFW
     if(!glfwInit())
     {
@@ -39,17 +126,24 @@ Window::Window(int width, int height, char const * title) :
 Window::~Window()
 {
     // Cleanup VBO and shader
-    if(mp_glfw_win)
+    if(mp_glfw_win || (m_headless && (!m_offscreen || m_offscreen->isCreated())))
     {
         m_render->terminate();
     }
 
     // Close OpenGL window and terminate GLFW
-    glfwTerminate();
+    if(!m_headless)
+        glfwTerminate();
 }
 
 void Window::create()
 {
+    if(m_headless)
+    {
+        createHeadless();
+        return;
+    }
+
     auto & cam = m_reg.get<CameraComponent>(m_camera);
 
     GLFWmonitor * mon;
@@ -74,6 +168,15 @@ void Window::create()
 
     GLFWwindow * new_window{nullptr};
     new_window = glfwCreateWindow(cam.m_vp_size.x, cam.m_vp_size.y, "", mon, mp_glfw_win);
+
+    // without sharing the GL objects go away with the old window
+    bool context_lost = false;
+    if(new_window == nullptr && mp_glfw_win != nullptr)
+    {
+        new_window   = glfwCreateWindow(cam.m_vp_size.x, cam.m_vp_size.y, "", mon, nullptr);
+        context_lost = new_window != nullptr;
+    }
+
     if(mp_glfw_win != nullptr)
         glfwDestroyWindow(mp_glfw_win);
 
@@ -99,6 +202,8 @@ void Window::create()
     // Ensure we can capture the escape key being pressed below
     glfwSetInputMode(mp_glfw_win, GLFW_STICKY_KEYS, GL_TRUE);
 
+    if(context_lost)
+        m_render->contextLost();
     m_render->init();
     m_render->setClearColor(glm::vec4(0.0f, 0.0f, 0.4f, 0.0f));
 
@@ -139,10 +244,46 @@ void Window::create()
 
     m_input_ptr->bindKeyFunctor(KeyboardKey::Key_Q, std::bind(&Window::objCreate, this), "create cube");
     m_input_ptr->bindKeyFunctor(KeyboardKey::Key_E, std::bind(&Window::objDelete, this), "delete cube");
+
+    m_input_ptr->bindKeyFunctor(KeyboardKey::Key_F2, std::bind(&Window::printMemoryReport, this),
+                                "memory report");
+}
+
+void Window::createHeadless()
+{
+    if(m_offscreen)
+    {
+        if(!m_offscreen->create())
+            throw std::runtime_error{std::string{"Failed to create offscreen GL context: "}
+                                     + m_offscreen->getError()};
+
+        // GLEW also initializes GLX, there is no X display without a window
+        GLenum const glew_result = glewInit();
+        if(glew_result != GLEW_OK && glew_result != GLEW_ERROR_NO_GLX_DISPLAY)
+            throw std::runtime_error{"Failed to initialize GLEW"};
+
+        if(!m_offscreen->initFramebuffer(m_size.x, m_size.y))
+            throw std::runtime_error{"Failed to create offscreen framebuffer"};
+    }
+
+    auto & cam = m_reg.get<CameraComponent>(m_camera);
+
+    cam.m_vp_size.x = m_size.x;
+    cam.m_vp_size.y = m_size.y;
+
+    m_render->setViewport(cam.m_vp_pos.x, cam.m_vp_pos.y, cam.m_vp_size.x, cam.m_vp_size.y);
+    CameraSystem::SetupProjMatrix(
+        cam, 45.0f, static_cast<float>(cam.m_vp_size.x) / static_cast<float>(cam.m_vp_size.y), 0.1f, 100.0f);
+
+    m_render->init();
+    m_render->setClearColor(glm::vec4(0.0f, 0.0f, 0.4f, 0.0f));
 }
 
 void Window::fullscreen(bool is_fullscreen)
 {
+    if(m_headless)
+        return;
+
     if(is_fullscreen == m_is_fullscreen)
         return;
 
@@ -150,7 +291,7 @@ void Window::fullscreen(bool is_fullscreen)
     create();
 }
 
-bool Window::createDefaultScene(int width, int height)
+bool Window::createSystems(std::unique_ptr<RenderBackend> backend)
 {
     // create systems
     // always first
@@ -158,6 +299,12 @@ bool Window::createDefaultScene(int width, int height)
     m_sys.addSystem(m_entity_creator_sys);
 
     m_scene_sys = std::make_shared<SceneSystem>(m_reg);
+    m_scene_sys->enableParallelUpdate(std::thread::hardware_concurrency());
+
+    // before the scene, streamed models are created in the same update
+    m_streamer = std::make_shared<WorldStreamer>(m_reg, *m_scene_sys);
+    m_sys.addSystem(m_streamer);
+
     m_sys.addSystem(m_scene_sys);
 
     std::shared_ptr<ISystem> ptr;
@@ -176,13 +323,18 @@ bool Window::createDefaultScene(int width, int height)
     m_model_sys = std::make_shared<ModelSystem>(m_reg);
     m_sys.addSystem(m_model_sys);
 
-    m_render = std::make_shared<Renderer>(m_reg);
+    m_render = std::make_shared<Renderer>(m_reg, std::move(backend));
     m_sys.addSystem(m_render);
 
     // always last
     ptr = std::make_shared<EntityDeleterSystem>(m_reg);
     m_sys.addSystem(ptr);
 
+    return true;
+}
+
+bool Window::createDefaultScene(int width, int height)
+{
     // add nodes
     Event::Scene::TransformComponent transform{};
     transform.replase_local_matrix = true;
@@ -213,26 +365,53 @@ bool Window::createDefaultScene(int width, int height)
     // light
     auto light_id = EntityBuilder::BuildEntity(m_reg, light_flags);
 
-    auto & light_pos = m_reg.get<SceneComponent>(light_id);
-    light_pos.rel    = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 5.0f));
+    auto & light_pos = m_reg.get<LocalTransformComponent>(light_id);
+    light_pos.rel    = evnt::Affine(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 5.0f)));
 
     m_scene_sys->connectNode(light_id, root);
 
     light_id = EntityBuilder::BuildEntity(m_reg, light_flags);
 
-    light_pos     = m_reg.get<SceneComponent>(light_id);
-    light_pos.rel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+    auto & light_pos2 = m_reg.get<LocalTransformComponent>(light_id);
+    light_pos2.rel    = evnt::Affine(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f)));
 
     m_scene_sys->connectNode(light_id, root);
 
     return true;
 }
 
+bool Window::restoreScene(std::string const & fname)
+{
+    if(!SceneSnapshot::Load(m_reg, *m_scene_sys, *m_model_sys, fname))
+        return false;
+
+    for(auto ent : m_reg.view<CameraComponent>())
+        m_camera = ent;
+
+    // the cube of a saved scene is a part of the model
+    for(auto ent : m_reg.view<CurrentAnimSequence>())
+        m_model = ent;
+
+    if(!NotNull(m_camera))
+        throw std::runtime_error{"No camera in the snapshot " + fname};
+
+    return true;
+}
+
+bool Window::saveSnapshot(std::string const & fname)
+{
+    return SceneSnapshot::Save(m_reg, m_scene_sys->getRoot(), fname);
+}
+
 void Window::initScene()
 {
     if(!m_sys.initSystems())
         throw std::runtime_error{"Failed to init systems"};
 
+    m_cube = null_entity_id;
+    if(m_restored)
+        return;
+
     m_entity_creator_sys->addCreatorFunctor([this]() {
         m_model = EntityBuilder::BuildEntity(m_reg, obj_flags);
 
@@ -240,12 +419,17 @@ void Window::initScene()
                                            mesh_fname,               // mesh data file
                                            anim_fname,               // anim data file
                                            diffuse_tex_fname,        // material data file
-                                           glm::mat4(1.0f)};         // relative matrix
+                                           glm::mat4(1.0f),          // relative matrix
+                                           nullptr};                 // read by ModelSystem
 
         m_reg.add_component<Event::Model::CreateModel>(m_model, std::move(cm_event));
     });
+}
 
-    m_cube = null_entity_id;
+void Window::loadWorld(std::string const & fname)
+{
+    if(!m_streamer->loadWorld(fname))
+        throw std::runtime_error{"Failed to load world " + fname};
 }
 
 void Window::run()
@@ -255,64 +439,217 @@ void Window::run()
     do
     {
         m_input_ptr->update();
-        // Clear the screen
-        m_render->clearBuffers();
 
         auto const & cam = m_reg.get<CameraComponent>(m_camera);
-        m_render->setMatrix(Renderer::MatrixType::PROJECTION, cam.m_proj_mat);
 
         m_scene_sys->updateQueues(cam.m_frustum, nullptr);
+        m_model_sys->selectLods(cam, m_scene_sys->getModelsQueue());
+        m_render->streamModels(m_scene_sys->getModelsQueue());
 
-        // set lights
-        for(uint32_t i = 0; i < m_scene_sys->getLightQueue().size() && i < 8; ++i)
-        {
-            if(i == 0)
-                m_render->lighting();
+        m_frame_builder.record(cam, m_scene_sys->getModelsQueue(), m_scene_sys->getLightQueue(), m_commands);
+        m_render->execute(m_commands);
 
-            auto const light_id = m_scene_sys->getLightQueue()[i];
+        // Swap buffers
+        glfwSwapBuffers(mp_glfw_win);
+        glfwPollEvents();
 
-            m_render->bindLight(light_id, i);
-        }
+        m_sys.update(glfwGetTime() / 10.0);
 
-        for(auto node : m_scene_sys->getModelsQueue())
+        if(glfwGetTime() - m_stats_time >= 1.0)
         {
-            auto const & node_pos   = m_reg.get<SceneComponent>(node);
-            glm::mat4    model_view = cam.m_view_mat * node_pos.abs;
+            auto const & stats = m_render->getStateStats();
+            std::string  title = m_title + " | state calls per frame: " + std::to_string(stats.issued)
+                                + " issued, " + std::to_string(stats.elided) + " elided";
+
+            glfwSetWindowTitle(mp_glfw_win, title.c_str());
+            m_stats_time = glfwGetTime();
+        }
+        m_render->resetStateStats();
+
+        if(m_input_ptr->isKeyPressed(KeyboardKey::Key_F1))
+            key_f1();
+
+        m_arcball.update(m_input_ptr.get(), m_camera, m_reg);
+    }   // Check if the ESC key was pressed or the window was closed
+    while(!m_input_ptr->isKeyPressed(KeyboardKey::Key_Escape) && glfwWindowShouldClose(mp_glfw_win) == 0);
+}
+
+void Window::runHeadless(uint32_t num_frames, uint32_t dump_interval, std::string const & record_fname,
+                         bool verify_state)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto const ms = [](clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
 
-            m_render->bindMaterial(node);
-            m_render->setMatrix(Renderer::MatrixType::MODELVIEW, model_view);
-            m_render->draw(node);
-            m_render->drawBBox(node);
+    std::ofstream record;
+    if(!record_fname.empty())
+    {
+        record.open(record_fname, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!record)
+            throw std::runtime_error{"Failed to open " + record_fname};
+
+        BinaryWriter header;
+        header.write(state_record_magic);
+        header.write(state_record_version);
+        record.write(reinterpret_cast<char const *>(header.getBuffer().data()),
+                     static_cast<std::streamsize>(header.getBuffer().size()));
+    }
+
+    auto &     backend = m_render->getBackend();
+    auto const start   = clock::now();
+
+    // loads the scene, not part of the frame cost
+    m_sys.update(0.0);
+    double const load_ms = ms(clock::now() - start);
+
+    BackendStats const load_stats = backend.getStats();
+
+    backend.resetStats();
+    m_render->resetStateStats();
+
+    double   cull_ms = 0.0, skin_ms = 0.0, record_ms = 0.0, execute_ms = 0.0, update_ms = 0.0;
+    uint64_t state_issued = 0, state_elided = 0;
+    uint64_t heap_allocs = 0, alloc_frames = 0;
+    // a key record on the first frame, deltas after it
+    SceneState   state;
+    BinaryWriter state_out;
+    double       state_ms    = 0.0;
+    uint64_t     state_bytes = 0, key_bytes = 0;
+    // every record is loaded into the replay and checked against m_reg
+    Registry   replay;
+    SceneState replay_state;
+    for(uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        auto const & cam = m_reg.get<CameraComponent>(m_camera);
+
+        uint64_t const allocs = GetHeapAllocations();
+        auto const     t0     = clock::now();
+        m_scene_sys->updateQueues(cam.m_frustum, nullptr);
+        m_model_sys->selectLods(cam, m_scene_sys->getModelsQueue());
+        auto const t1 = clock::now();
+        m_render->streamModels(m_scene_sys->getModelsQueue());
+        auto const t2 = clock::now();
+        m_frame_builder.record(cam, m_scene_sys->getModelsQueue(), m_scene_sys->getLightQueue(), m_commands);
+        auto const t3 = clock::now();
+        m_render->execute(m_commands);
+        backend.endFrame();
+        if(m_offscreen)
+            m_offscreen->finish();
+        auto const t4 = clock::now();
+        // animation and uploads for the next frame
+        m_sys.update(static_cast<double>(frame + 1) * headless_time_step);
+        auto const t5 = clock::now();
+
+        cull_ms += ms(t1 - t0);
+        skin_ms += ms(t2 - t1);
+        record_ms += ms(t3 - t2);
+        execute_ms += ms(t4 - t3);
+        update_ms += ms(t5 - t4);
+
+        uint64_t const frame_allocs = GetHeapAllocations() - allocs;
+        heap_allocs += frame_allocs;
+        alloc_frames += frame_allocs > 0 ? 1 : 0;
+
+        state_issued += m_render->getStateStats().issued;
+        state_elided += m_render->getStateStats().elided;
+        m_render->resetStateStats();
+
+        if(record.is_open() || verify_state)
+        {
+            auto const t6 = clock::now();
+            state_out.clear();
+            state.saveDelta(m_reg, state_out);
+            state_ms += ms(clock::now() - t6);
+
+            // each record is prefixed with its size
+            auto const &   buffer = state_out.getBuffer();
+            uint64_t const size   = buffer.size();
+            if(record.is_open())
+            {
+                record.write(reinterpret_cast<char const *>(&size), sizeof(size));
+                record.write(reinterpret_cast<char const *>(buffer.data()),
+                             static_cast<std::streamsize>(size));
+            }
+
+            (frame == 0 ? key_bytes : state_bytes) += size;
         }
 
-        for(uint32_t i = 0; i < m_scene_sys->getLightQueue().size() && i < 8; ++i)
+        if(verify_state)
         {
-            if(i == 0)
-                m_render->lighting(false);
+            auto const & buffer = state_out.getBuffer();
+            BinaryReader in(buffer.data(), buffer.size());
+            if(!replay_state.load(replay, in) || !in.isEnd() || !SameState(replay_state, m_reg, replay))
+                throw std::runtime_error{"The state record of frame " + std::to_string(frame)
+                                         + " doesn't replay"};
+        }
 
-            m_render->unbindLight(i);
+        // the framebuffer still holds the frame recorded before the update
+        if(m_offscreen && dump_interval > 0 && frame % dump_interval == 0)
+        {
+            tex::ImageData image;
+            if(m_offscreen->readPixels(image))
+                tex::WriteTGA("frame_" + std::to_string(frame) + ".tga", image);
         }
+    }
 
-        m_render->loadIdentityMatrix(Renderer::MatrixType::PROJECTION);
-        m_render->loadIdentityMatrix(Renderer::MatrixType::MODELVIEW);
+    auto const & stats = backend.getStats();
+    double const n     = num_frames > 0 ? static_cast<double>(num_frames) : 1.0;
+
+    std::cout << (m_offscreen ? "offscreen" : "headless") << " run: " << num_frames << " frames, scene load "
+              << load_ms << " ms\n"
+              << "  per frame, ms: cull " << cull_ms / n << ", skin " << skin_ms / n << ", record "
+              << record_ms / n << ", execute " << execute_ms / n << ", update " << update_ms / n << ", total "
+              << (cull_ms + skin_ms + record_ms + execute_ms + update_ms) / n << "\n"
+              << "  heap allocations: " << static_cast<double>(heap_allocs) / n << " per frame, "
+              << alloc_frames << " frames allocated" << std::endl;
+    if(record.is_open() || verify_state)
+    {
+        double const deltas = num_frames > 1 ? static_cast<double>(num_frames - 1) : 1.0;
 
-        // Swap buffers
-        glfwSwapBuffers(mp_glfw_win);
-        glfwPollEvents();
+        record.close();
+        if(!record_fname.empty() && !record)
+            throw std::runtime_error{"Failed to write " + record_fname};
 
-        m_sys.update(glfwGetTime() / 10.0);
+        std::cout << "  state record: key " << key_bytes << " bytes, delta "
+                  << static_cast<double>(state_bytes) / deltas << " bytes and " << state_ms / n
+                  << " ms per frame" << std::endl;
+        if(verify_state)
+            std::cout << "  state replay: " << num_frames << " records match the registry" << std::endl;
+    }
+    printMemoryReport();
 
-        if(m_input_ptr->isKeyPressed(KeyboardKey::Key_F1))
-            key_f1();
+    // the GL backend doesn't count
+    if(backend.needsContext())
+        return;
 
-        m_arcball.update(m_input_ptr.get(), m_camera, m_reg);
-    }   // Check if the ESC key was pressed or the window was closed
-    while(!m_input_ptr->isKeyPressed(KeyboardKey::Key_Escape) && glfwWindowShouldClose(mp_glfw_win) == 0);
+    std::cout << "  per frame: " << static_cast<double>(stats.calls) / n << " gl calls, "
+              << static_cast<double>(stats.draw_calls) / n << " draws, "
+              << static_cast<double>(stats.indices) / n << " indices, "
+              << static_cast<double>(stats.mapped_bytes) / n << " mapped bytes, "
+              << static_cast<double>(state_issued) / n << " state calls issued, "
+              << static_cast<double>(state_elided) / n << " elided\n"
+              << "  uploaded: " << load_stats.buffer_bytes + stats.buffer_bytes << " buffer bytes, "
+              << load_stats.texture_bytes + stats.texture_bytes << " texture bytes" << std::endl;
+}
+
+void Window::printMemoryReport() const
+{
+    MemoryReport report;
+
+    report.add(MemTag::Ecs, m_reg.memory());
+    m_model_sys->accountMemory(report);
+    m_render->accountMemory(report);
+
+    report.write(std::cout);
+
+    if(m_streamer->getNumResidentCells() > 0)
+        std::cout << "streamed world: " << m_streamer->getNumResidentCells() << " cells, "
+                  << m_streamer->getResidentBytes() / 1024 << " KB of model data" << std::endl;
 }
 
 void Window::moveForward(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_camera);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_camera);
 
     glm::vec4 dir     = pos.abs * glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
     glm::vec4 new_pos = dir * speed;
@@ -328,7 +665,7 @@ void Window::moveForward(float speed)
 
 void Window::moveSideward(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_camera);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_camera);
 
     glm::vec4 right   = pos.abs * glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
     glm::vec4 new_pos = right * speed;
@@ -344,7 +681,7 @@ void Window::moveSideward(float speed)
 
 void Window::moveUp(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_camera);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_camera);
 
     glm::vec4 up      = pos.abs * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
     glm::vec4 new_pos = up * speed;
@@ -360,7 +697,7 @@ void Window::moveUp(float speed)
 
 void Window::objMoveUp(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_model);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_model);
 
     glm::vec4 up      = pos.abs * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
     glm::vec4 new_pos = up * speed;
@@ -376,7 +713,7 @@ void Window::objMoveUp(float speed)
 
 void Window::objMoveSide(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_model);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_model);
 
     glm::vec4 up      = pos.abs * glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
     glm::vec4 new_pos = up * speed;
@@ -392,7 +729,7 @@ void Window::objMoveSide(float speed)
 
 void Window::objRotateUp(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_model);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_model);
 
     glm::vec4 up        = pos.abs * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
     glm::mat4 new_trans = glm::rotate(glm::mat4(1.0f), speed, glm::vec3(up));
@@ -406,7 +743,7 @@ void Window::objRotateUp(float speed)
 
 void Window::objRotateSide(float speed)
 {
-    auto const & pos = m_reg.get<SceneComponent>(m_model);
+    auto const & pos = m_reg.get<WorldTransformComponent>(m_model);
 
     glm::vec4 up        = pos.abs * glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
     glm::mat4 new_trans = glm::rotate(glm::mat4(1.0f), speed, glm::vec3(up));
@@ -420,7 +757,7 @@ void Window::objRotateSide(float speed)
 
 void Window::objCreate()
 {
-    if(m_reg.valid(m_cube))
+    if(m_reg.valid(m_cube) || !m_reg.valid(m_model))
         return;
 
     m_entity_creator_sys->addCreatorFunctor([this]() {
@@ -434,7 +771,8 @@ void Window::objCreate()
                 "cube.txt.msh",                                          // mesh data file
                 "",                                                      // anim data file
                 diffuse_tex_fname,                                       // material data file
-                glm::translate(glm::mat4(1.0f), {0.0f, -5.0f, 0.0f})};   // relative matrix
+                glm::translate(glm::mat4(1.0f), {0.0f, -5.0f, 0.0f}),    // relative matrix
+                nullptr};                                                // read by ModelSystem
 
             m_reg.add_component<Event::Model::CreateModel>(m_cube, std::move(cm_event));
         }
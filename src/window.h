@@ -15,6 +15,10 @@
 #include "input/arcball.h"
 #include "scene/scenecmp.h"
 #include "scene/model.h"
+#include "scene/streaming.h"
+#include "render/framebuilder.h"
+#include "render/renderbackend.h"
+#include "render/offscreencontext.h"
 
 class Renderer;
 
@@ -26,37 +30,67 @@ class Window
     GLFWwindow *        mp_glfw_win        = nullptr;
     glm::ivec2 const    m_size;   // initial size
     std::string         m_title;
+    double              m_stats_time = 0.0;   // last title update with the renderer counters
+    bool const          m_headless;           // no window and no input
+    // GL backend without a display
+    std::unique_ptr<OffscreenContext> m_offscreen;
 
     std::unique_ptr<Input> m_input_ptr;
     Arcball                m_arcball;
 
+    bool m_restored = false;   // the scene comes from a snapshot
+
+    bool createSystems(std::unique_ptr<RenderBackend> backend);
     bool createDefaultScene(int width, int height);
+    bool restoreScene(std::string const & fname);
+    void createHeadless();
 
 public:
+    // declared first, the systems disconnect their observers from it on destruction
+    Registry m_reg;
     // World
-    Entity                               m_camera;
-    Entity                               m_model;
-    Entity                               m_cube;
+    Entity                               m_camera = null_entity_id;
+    Entity                               m_model  = null_entity_id;
+    Entity                               m_cube   = null_entity_id;
     std::shared_ptr<EntityCreatorSystem> m_entity_creator_sys;
     std::shared_ptr<SceneSystem>         m_scene_sys;
+    std::shared_ptr<WorldStreamer>       m_streamer;
     std::shared_ptr<ModelSystem>         m_model_sys;
     std::shared_ptr<Renderer>            m_render;
     // App
-    Registry   m_reg;
-    SystemsMgr m_sys;
+    SystemsMgr    m_sys;
+    FrameBuilder  m_frame_builder;
+    CommandBuffer m_commands;
 
-    Window(int width, int height, char const * title);
+    // the scene is restored from snapshot_fname if it can be read, else the
+    // default scene is built
+    Window(int width, int height, char const * title, std::unique_ptr<RenderBackend> backend,
+           bool offscreen = false, std::string const & snapshot_fname = {});
     ~Window();
 
     Window(Window const &)             = delete;
     Window & operator=(Window const &) = delete;
 
     bool isFullscreen() const { return m_is_fullscreen; }
+    bool isHeadless() const { return m_headless; }
+    bool isRestored() const { return m_restored; }
 
     void create();
     void initScene();
+    // models of the world file are streamed in around the camera
+    void loadWorld(std::string const & fname);
+    // scene nodes and the model blobs for the next start
+    bool saveSnapshot(std::string const & fname);
     void fullscreen(bool is_fullscreen);
     void run();
+    // fixed time step loop without presentation, prints the frame cost, offscreen
+    // runs write every dump_interval frame to a tga, the scene state of every
+    // frame goes to record_fname as a key record and deltas, verify_state loads
+    // each record into a second registry and throws if it differs
+    void runHeadless(uint32_t num_frames, uint32_t dump_interval = 0, std::string const & record_fname = {},
+                     bool verify_state = false);
+    // live memory by subsystem and the tagged heap totals, to stdout
+    void printMemoryReport() const;
 
     // camera move
     void moveForward(float speed);